@@ -5,6 +5,7 @@
 #-------------------------------------------------
 
 QT       -= gui
+CONFIG   += c++11
 
 
 TEMPLATE = lib
@@ -54,3 +55,10 @@ HEADERS += \
 
 SOURCES += \
     src/consoleappender.cpp
+
+HEADERS += \
+    src/loggerqueue.h \
+    src/loggerwriter.h
+
+SOURCES += \
+    src/loggerwriter.cpp
@@ -10,13 +10,19 @@
 void ConsoleAppender::write (const LoggerEvent &event)
 {
     mutex.lock();
-    QTextStream out(stream);
     streamWrite(out, event);
     mutex.unlock();
 }
 
+void ConsoleAppender::flush ()
+{
+    mutex.lock();
+    out.flush();
+    mutex.unlock();
+}
+
 ConsoleAppender::ConsoleAppender (int level, FILE *stream, const QString &format) :
-LoggerAppender(format, level)
+LoggerAppender(format, level), out(stream)
 {
     this->stream = stream;
 }
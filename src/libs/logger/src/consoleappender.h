@@ -14,8 +14,12 @@ class ConsoleAppender: public LoggerAppender
     public:
         FILE *stream;
 
+    private:
+        QTextStream out;
+
     public:
         void write (const LoggerEvent &event);
+        void flush ();
         ConsoleAppender (int level, FILE *stream, const QString &format);
 };
 
@@ -7,11 +7,14 @@
 #include "logger.h"
 #include "loggerevent.h"
 #include "loggerappender.h"
+#include "loggerwriter.h"
 
+std::atomic<int> LoggerEngine::levelMask_(0);
+std::atomic<int> LoggerEngine::levelFilter_(LoggerEngine::LevelAll);
 
-bool LoggerEngine::isEventAccepted (LoggerAppender *appender, LoggerEvent &event)
+bool LoggerEngine::isEventAccepted (LoggerAppender *appender, const LoggerEvent &event)
 {
-    if (!(appender->level() & event.level))
+    if (!(appender->level() & levelFilter_ & event.level))
        return false;
     return true;
 }
@@ -19,6 +22,14 @@ bool LoggerEngine::isEventAccepted (LoggerAppender *appender, LoggerEvent &event
 void LoggerEngine::logEvent (LoggerLevel level,
                              const QString &message, const char *file, int line)
 {
+    LoggerWriter *writer = handle().writer_;
+
+    if (writer && level < LevelCritical)
+        {
+            writer->push(level, message, file, line);
+            return;
+        }
+
     LoggerEvent event;
     event.dateTime = QDateTime::currentDateTime();
     event.level    = level;
@@ -26,6 +37,18 @@ void LoggerEngine::logEvent (LoggerLevel level,
     event.file     = file;
     event.line     = line;
 
+    if (writer)
+        {
+            writer->writeNow(event);
+            return;
+        }
+
+    dispatch(event);
+    flushAppenders();
+}
+
+void LoggerEngine::dispatch (const LoggerEvent &event)
+{
     foreach (LoggerAppender *appender, handle().appenders_ )
         {
             if (isEventAccepted(appender, event) == true)
@@ -35,6 +58,53 @@ void LoggerEngine::logEvent (LoggerLevel level,
         }
 }
 
+void LoggerEngine::flushAppenders ()
+{
+    foreach (LoggerAppender *appender, handle().appenders_ )
+        {
+            appender->flush();
+        }
+}
+
+void LoggerEngine::startAsync ()
+{
+    LoggerEngine &engine = handle();
+
+    if (engine.writer_)
+        return;
+
+    engine.writer_ = new LoggerWriter;
+    engine.writer_->start(QThread::LowPriority);
+}
+
+void LoggerEngine::stopAsync ()
+{
+    LoggerEngine &engine = handle();
+
+    if (!engine.writer_)
+        return;
+
+    engine.writer_->stop();
+    delete engine.writer_;
+    engine.writer_ = NULL;
+}
+
+void LoggerEngine::flush ()
+{
+    LoggerWriter *writer = handle().writer_;
+
+    if (writer)
+        writer->flush();
+}
+
+void LoggerEngine::flushToFd (int fd)
+{
+    LoggerWriter *writer = handle().writer_;
+
+    if (writer)
+        writer->flushToFd(fd);
+}
+
 const char * LoggerEngine::levelName (LoggerLevel level)
 {
     switch (level)
@@ -53,6 +123,12 @@ const char * LoggerEngine::levelName (LoggerLevel level)
 
 LoggerEngine::~LoggerEngine ()
 {
+    if (writer_)
+        {
+            writer_->stop();
+            delete writer_;
+        }
+
     foreach (LoggerAppender *appender, appenders_)
         {
             delete appender;
@@ -65,5 +141,24 @@ void LoggerEngine::addAppender(LoggerAppender *appender)
     if (appender)
         {
             handle().appenders_ << appender;
+            updateLevelMask();
         }
 }
+
+void LoggerEngine::setLevelFilter (int levels)
+{
+    levelFilter_ = levels & LevelAll;
+    updateLevelMask();
+}
+
+void LoggerEngine::updateLevelMask ()
+{
+    int mask = 0;
+
+    foreach (LoggerAppender *appender, handle().appenders_)
+        {
+            mask |= appender->level();
+        }
+
+    levelMask_ = mask & levelFilter_;
+}
@@ -13,18 +13,33 @@
 #include <QDateTime>
 #include <QTextStream>
 
+#include <atomic>
+
+// Levels below LOG_MIN_LEVEL are compiled out, e.g. DEFINES += LOG_MIN_LEVEL=2
+// drops all the debug messages from a build
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL 1
+#endif
+
 class LoggerAppender;
 class LoggerEvent;
+class LoggerWriter;
 
 class LoggerEngine
 {
 
 private:
     friend class LoggerAppender;
+    friend class LoggerWriter;
     QTime                   startTime_;
     QList<LoggerAppender *> appenders_;
+    LoggerWriter           *writer_;
+
+    static std::atomic<int> levelMask_;
+    static std::atomic<int> levelFilter_;
 
 private:
+    LoggerEngine () : writer_(NULL) {}
     static LoggerEngine &handle()
         {
             static LoggerEngine hInstance;
@@ -48,23 +63,82 @@ public:
 
 public:
     static void     addAppender(LoggerAppender *appender);
+
+    // Levels which may be written at all, LevelAll by default
+    static void     setLevelFilter  (int levels);
+
+    // True if at least one appender accepts the level. The log macros check
+    // it before the message is built.
+    static bool     isEnabled       (LoggerLevel level)
+        {
+            return (levelMask_.load(std::memory_order_relaxed) & level) != 0;
+        }
+
+    static QString  formatMessage   (const QString &format)
+        {
+            return format;
+        }
+
+    // Substitutes %1, %2, ... with the arguments in order
+    template<typename T, typename... Args>
+    static QString  formatMessage   (const QString &format, const T &arg,
+                                     const Args &... args)
+        {
+            return formatMessage(format.arg(arg), args...);
+        }
+
     static void     logEvent        (LoggerLevel level,
                                      const QString &message,
                                      const char *file,
                                      int line);
-    static bool     isEventAccepted (LoggerAppender *appender, LoggerEvent &event);
+    static bool     isEventAccepted (LoggerAppender *appender, const LoggerEvent &event);
+
+    // Moves the formatting and writing of the events to a background thread.
+    // The appenders must be added before the start. Critical, fatal and
+    // exception events are still written immediately, after the queued ones.
+    static void     startAsync      ();
+    static void     stopAsync       ();
+
+    // Writes out the queued events
+    static void     flush           ();
+
+    // Writes the queued events to the file descriptor with write() only,
+    // for the signal handlers. Best effort, see LoggerWriter::flushToFd().
+    static void     flushToFd       (int fd);
 
     static const char *levelName(LoggerLevel level);
+
+private:
+    static void     dispatch        (const LoggerEvent &event);
+    static void     flushAppenders  ();
+    static void     updateLevelMask ();
 };
 
 
-#define logDebug(message)     LoggerEngine::logEvent(LoggerEngine::LevelDebug, message, __FILE__, __LINE__)
-#define logInfo(message)      LoggerEngine::logEvent(LoggerEngine::LevelInfo, message, __FILE__, __LINE__)
-#define logWarn(message)      LoggerEngine::logEvent(LoggerEngine::LevelWarn, message, __FILE__, __LINE__)
-#define logError(message)     LoggerEngine::logEvent(LoggerEngine::LevelError, message, __FILE__, __LINE__)
-#define logFatal(message)     LoggerEngine::logEvent(LoggerEngine::LevelFatal, message, __FILE__, __LINE__)
-#define logCritical(message)  LoggerEngine::logEvent(LoggerEngine::LevelCritical, message, __FILE__, __LINE__)
-#define logException(message) LoggerEngine::logEvent(LoggerEngine::LevelException, message, __FILE__, __LINE__)
+// The message is evaluated only if the level is enabled, so a disabled log
+// statement costs one load and a branch.
+#define LOG_EVENT(level, message) \
+    do { \
+        if ((level) >= LOG_MIN_LEVEL && LoggerEngine::isEnabled(level)) \
+            LoggerEngine::logEvent(level, message, __FILE__, __LINE__); \
+    } while (0)
+
+// logInfof("Loaded %1 balls in %2 ms", count, time)
+#define LOG_FORMAT(level, ...) \
+    LOG_EVENT(level, LoggerEngine::formatMessage(__VA_ARGS__))
+
+#define logDebug(message)     LOG_EVENT(LoggerEngine::LevelDebug, message)
+#define logInfo(message)      LOG_EVENT(LoggerEngine::LevelInfo, message)
+#define logWarn(message)      LOG_EVENT(LoggerEngine::LevelWarn, message)
+#define logError(message)     LOG_EVENT(LoggerEngine::LevelError, message)
+#define logFatal(message)     LOG_EVENT(LoggerEngine::LevelFatal, message)
+#define logCritical(message)  LOG_EVENT(LoggerEngine::LevelCritical, message)
+#define logException(message) LOG_EVENT(LoggerEngine::LevelException, message)
+
+#define logDebugf(...)        LOG_FORMAT(LoggerEngine::LevelDebug, __VA_ARGS__)
+#define logInfof(...)         LOG_FORMAT(LoggerEngine::LevelInfo, __VA_ARGS__)
+#define logWarnf(...)         LOG_FORMAT(LoggerEngine::LevelWarn, __VA_ARGS__)
+#define logErrorf(...)        LOG_FORMAT(LoggerEngine::LevelError, __VA_ARGS__)
 
 
 #endif // LOGGER_H
@@ -10,18 +10,38 @@
 void LoggerAppender::streamWrite (QTextStream &stream, const LoggerEvent &event)
 {
     stream << format(event);
-    stream.flush();
 }
 
+// One pass over the format, unknown specifiers are copied as is
 QString LoggerAppender::format(const LoggerEvent &event)
 {
-    QString message = QString(_format);
-    message.replace("%d", event.dateTime.toString("hh:mm:ss.zzz"));
-    message.replace("%l", LoggerEngine::levelName(event.level));
-    message.replace("%i", QString("%1").arg(event.line));
-    message.replace("%f", QString(event.file));
-    message.replace("%m", *(event.message));
-    message.replace("%n", "\n");
+    QString message;
+    message.reserve(_format.size() + event.message->size() + 64);
+
+    const QChar *c   = _format.constData();
+    const QChar *end = c + _format.size();
+
+    for (; c != end; ++c)
+        {
+            if (*c != QLatin1Char('%') || c + 1 == end)
+                {
+                    message += *c;
+                    continue;
+                }
+
+            switch ((++c)->toLatin1())
+                {
+                case 'd': message += event.dateTime.toString("hh:mm:ss.zzz"); break;
+                case 'l': message += QLatin1String(LoggerEngine::levelName(event.level)); break;
+                case 'i': message += QString::number(event.line); break;
+                case 'f': message += QLatin1String(event.file); break;
+                case 'm': message += *(event.message); break;
+                case 'n': message += QLatin1Char('\n'); break;
+                default:
+                    message += QLatin1Char('%');
+                    message += *c;
+                }
+        }
 
     return message;
 }
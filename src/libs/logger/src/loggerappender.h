@@ -25,6 +25,7 @@ protected:
 
 public:
     virtual void write (const LoggerEvent &event) = 0;
+    virtual void flush () {}
     LoggerEngine::LoggerLevel level();
     virtual ~LoggerAppender(){}
 };
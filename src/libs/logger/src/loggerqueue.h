@@ -0,0 +1,152 @@
+/*******************************************************************************
+*  file    : loggerqueue.h
+*  created : 19.10.2026
+*  author  : 
+*******************************************************************************/
+
+#ifndef LOGGERQUEUE_H
+#define LOGGERQUEUE_H
+
+#include "logger.h"
+
+#include <atomic>
+#include <cstddef>
+
+struct LoggerRecord
+{
+    LoggerEngine::LoggerLevel level;
+    qint64        time;     // msecs since epoch
+    const char    *file;
+    int           line;
+    QString       message;
+};
+
+// Bounded multi-producer/single-consumer queue of the log records.
+// Every cell carries a sequence number, so the producers only race on the
+// enqueue position and never on the same cell. push() fails when the queue
+// is full instead of blocking or allocating.
+class LoggerQueue
+{
+public:
+    enum { SIZE = 4096 };
+
+private:
+    struct Cell
+    {
+        std::atomic<std::size_t> sequence;
+        LoggerRecord record;
+    };
+
+    Cell cells_[SIZE];
+    std::atomic<std::size_t> enqueuePos_;
+    std::atomic<std::size_t> dequeuePos_;
+
+    LoggerQueue(const LoggerQueue&);
+    LoggerQueue& operator=(const LoggerQueue&);
+
+public:
+    LoggerQueue() : enqueuePos_(0), dequeuePos_(0)
+        {
+            for (std::size_t i = 0; i < SIZE; ++i)
+                cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+    bool push(LoggerEngine::LoggerLevel level, qint64 time,
+                     const QString &message, const char *file, int line)
+        {
+            std::size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+            Cell *cell;
+
+            for (;;)
+                {
+                    cell = &cells_[pos & (SIZE - 1)];
+                    std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+                    std::ptrdiff_t diff = std::ptrdiff_t(seq) - std::ptrdiff_t(pos);
+
+                    if (diff == 0)
+                        {
+                            if (enqueuePos_.compare_exchange_weak(pos, pos + 1,
+                                                                  std::memory_order_relaxed))
+                                break;
+                        }
+                    else if (diff < 0)
+                        {
+                            return false;
+                        }
+                    else
+                        {
+                            pos = enqueuePos_.load(std::memory_order_relaxed);
+                        }
+                }
+
+            cell->record.level   = level;
+            cell->record.time    = time;
+            cell->record.file    = file;
+            cell->record.line    = line;
+            cell->record.message = message;
+            cell->sequence.store(pos + 1, std::memory_order_release);
+
+            return true;
+        }
+
+    // Approximate number of the waiting records, may be called from any thread
+    std::size_t size() const
+        {
+            std::size_t dequeuePos = dequeuePos_.load(std::memory_order_relaxed);
+            std::size_t enqueuePos = enqueuePos_.load(std::memory_order_relaxed);
+
+            return enqueuePos > dequeuePos ? enqueuePos - dequeuePos : 0;
+        }
+
+    // Consumer side only
+    bool pop(LoggerRecord *record)
+        {
+            std::size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+            Cell *cell = &cells_[pos & (SIZE - 1)];
+
+            if (cell->sequence.load(std::memory_order_acquire) != pos + 1)
+                return false;
+
+            record->level = cell->record.level;
+            record->time  = cell->record.time;
+            record->file  = cell->record.file;
+            record->line  = cell->record.line;
+            record->message.swap(cell->record.message);
+            cell->record.message.clear();
+
+            cell->sequence.store(pos + SIZE, std::memory_order_release);
+            dequeuePos_.store(pos + 1, std::memory_order_relaxed);
+
+            return true;
+        }
+
+    // Consumer side only. Hands the next record to f where it lies and
+    // releases the cell; nothing is copied, allocated or freed, so it may
+    // be called from a signal handler. The message is freed by the next
+    // push() into the cell.
+    template<class F> bool consume(F f)
+        {
+            std::size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+            Cell *cell = &cells_[pos & (SIZE - 1)];
+
+            if (cell->sequence.load(std::memory_order_acquire) != pos + 1)
+                return false;
+
+            f(cell->record);
+
+            cell->sequence.store(pos + SIZE, std::memory_order_release);
+            dequeuePos_.store(pos + 1, std::memory_order_relaxed);
+
+            return true;
+        }
+
+    // Consumer side only
+    bool isEmpty() const
+        {
+            std::size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+
+            return cells_[pos & (SIZE - 1)].sequence.load(std::memory_order_acquire) != pos + 1;
+        }
+};
+
+#endif // LOGGERQUEUE_H
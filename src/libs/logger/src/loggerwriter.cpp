@@ -0,0 +1,269 @@
+/*******************************************************************************
+*  file    : loggerwriter.cpp
+*  created : 19.10.2026
+*  author  : 
+*******************************************************************************/
+
+#include "loggerwriter.h"
+#include "loggerevent.h"
+
+#ifdef Q_OS_WIN
+#   include <io.h>
+#else
+#   include <unistd.h>
+#endif
+
+namespace
+{
+const unsigned long FLUSH_INTERVAL = 50;  // ms
+const int           LOCK_TIMEOUT   = 100; // ms
+const std::size_t   HIGH_WATER     = LoggerQueue::SIZE / 2;
+
+// Formats into a fixed buffer which is written out with write() when it's
+// full, nothing is allocated. Used on the crash path.
+class RawOutput
+{
+private:
+    enum { SIZE = 1024 };
+
+    int         fd_;
+    std::size_t size_;
+    char        buffer_[SIZE];
+
+public:
+    explicit RawOutput (int fd) : fd_(fd), size_(0) {}
+
+    void put (char c)
+        {
+            if (size_ == SIZE)
+                flush();
+
+            buffer_[size_++] = c;
+        }
+
+    void append (const char *str)
+        {
+            while (*str)
+                put(*str++);
+        }
+
+    void append (int value)
+        {
+            char digits[16];
+            int n = 0;
+            unsigned u = value < 0 ? 0u - unsigned(value) : unsigned(value);
+
+            do
+                {
+                    digits[n++] = char('0' + u % 10);
+                    u /= 10;
+                }
+            while (u);
+
+            if (value < 0)
+                put('-');
+
+            while (n)
+                put(digits[--n]);
+        }
+
+    // As UTF-8, without QString::toUtf8(), which allocates
+    void append (const QString &str)
+        {
+            const QChar *data = str.constData();
+            int length = str.size();
+
+            for (int i = 0; i < length; ++i)
+                {
+                    uint c = data[i].unicode();
+
+                    if (QChar::isHighSurrogate(c) && i + 1 < length
+                        && data[i + 1].isLowSurrogate())
+                        c = QChar::surrogateToUcs4(ushort(c), data[++i].unicode());
+
+                    if (c < 0x80)
+                        {
+                            put(char(c));
+                        }
+                    else if (c < 0x800)
+                        {
+                            put(char(0xC0 | (c >> 6)));
+                            put(char(0x80 | (c & 0x3F)));
+                        }
+                    else if (c < 0x10000)
+                        {
+                            put(char(0xE0 | (c >> 12)));
+                            put(char(0x80 | ((c >> 6) & 0x3F)));
+                            put(char(0x80 | (c & 0x3F)));
+                        }
+                    else
+                        {
+                            put(char(0xF0 | (c >> 18)));
+                            put(char(0x80 | ((c >> 12) & 0x3F)));
+                            put(char(0x80 | ((c >> 6) & 0x3F)));
+                            put(char(0x80 | (c & 0x3F)));
+                        }
+                }
+        }
+
+    void flush ()
+        {
+            const char *data = buffer_;
+
+            while (size_ > 0)
+                {
+#ifdef Q_OS_WIN
+                    int n = _write(fd_, data, unsigned(size_));
+#else
+                    ssize_t n = ::write(fd_, data, size_);
+#endif
+                    if (n <= 0)
+                        break;
+
+                    data  += n;
+                    size_ -= std::size_t(n);
+                }
+
+            size_ = 0;
+        }
+};
+}
+
+LoggerWriter::LoggerWriter () : stopped_(false), dropped_(0), consuming_(false)
+{
+}
+
+void LoggerWriter::push (LoggerEngine::LoggerLevel level, const QString &message,
+                         const char *file, int line)
+{
+    if (!queue_.push(level, QDateTime::currentMSecsSinceEpoch(), message, file, line))
+        {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            wakeup_.wakeOne();
+        }
+    else if (queue_.size() >= HIGH_WATER)
+        {
+            wakeup_.wakeOne();
+        }
+}
+
+void LoggerWriter::writeNow (const LoggerEvent &event)
+{
+    // Waits for the writer however long it takes, the event is never lost
+    drainMutex_.lock();
+    drain();
+    LoggerEngine::dispatch(event);
+    LoggerEngine::flushAppenders();
+    drainMutex_.unlock();
+}
+
+void LoggerWriter::flush ()
+{
+    if (!drainMutex_.tryLock(LOCK_TIMEOUT))
+        return;
+
+    drain();
+    drainMutex_.unlock();
+}
+
+void LoggerWriter::flushToFd (int fd)
+{
+    bool expected = false;
+
+    if (!consuming_.compare_exchange_strong(expected, true, std::memory_order_acquire))
+        return;
+
+    RawOutput out(fd);
+
+    while (queue_.consume([&out](const LoggerRecord &record)
+                          {
+                              out.append(LoggerEngine::levelName(record.level));
+                              out.append(" - ");
+                              out.append(record.message);
+                              out.append(" [");
+                              out.append(record.file ? record.file : "");
+                              out.put(':');
+                              out.append(record.line);
+                              out.append("]\n");
+                          }))
+        ;
+
+    unsigned dropped = dropped_.load(std::memory_order_relaxed);
+
+    if (dropped)
+        {
+            out.append("Warn - ");
+            out.append(int(dropped));
+            out.append(" log messages dropped\n");
+        }
+
+    out.flush();
+    consuming_.store(false, std::memory_order_release);
+}
+
+void LoggerWriter::stop ()
+{
+    stopped_ = true;
+    wakeup_.wakeOne();
+    wait();
+}
+
+void LoggerWriter::run ()
+{
+    while (!stopped_)
+        {
+            waitMutex_.lock();
+            if (!stopped_ && queue_.isEmpty())
+                wakeup_.wait(&waitMutex_, FLUSH_INTERVAL);
+            waitMutex_.unlock();
+
+            flush();
+        }
+
+    flush();
+}
+
+void LoggerWriter::drain ()
+{
+    LoggerRecord record;
+    LoggerEvent event;
+    bool written = false;
+    bool expected = false;
+
+    // The crash handler may be writing the queue out
+    if (!consuming_.compare_exchange_strong(expected, true, std::memory_order_acquire))
+        return;
+
+    while (queue_.pop(&record))
+        {
+            event.dateTime = QDateTime::fromMSecsSinceEpoch(record.time);
+            event.level    = record.level;
+            event.message  = &record.message;
+            event.file     = record.file;
+            event.line     = record.line;
+
+            LoggerEngine::dispatch(event);
+            written = true;
+        }
+
+    consuming_.store(false, std::memory_order_release);
+
+    unsigned dropped = dropped_.exchange(0, std::memory_order_relaxed);
+
+    if (dropped)
+        {
+            QString message = QString("%1 log messages dropped").arg(dropped);
+
+            event.dateTime = QDateTime::currentDateTime();
+            event.level    = LoggerEngine::LevelWarn;
+            event.message  = &message;
+            event.file     = __FILE__;
+            event.line     = __LINE__;
+
+            LoggerEngine::dispatch(event);
+            written = true;
+        }
+
+    if (written)
+        LoggerEngine::flushAppenders();
+}
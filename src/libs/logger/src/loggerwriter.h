@@ -0,0 +1,60 @@
+/*******************************************************************************
+*  file    : loggerwriter.h
+*  created : 19.10.2026
+*  author  : 
+*******************************************************************************/
+
+#ifndef LOGGERWRITER_H
+#define LOGGERWRITER_H
+
+#include "loggerqueue.h"
+
+#include <QThread>
+#include <QWaitCondition>
+
+// Background thread of the asynchronous logging. The producers only copy
+// the message into the queue; the events are formatted and written to the
+// appenders here, in batches, and the appenders are flushed once per batch.
+// When the queue is full new records are dropped and the count of the lost
+// records is reported with the next batch.
+class LoggerWriter : public QThread
+{
+private:
+    LoggerQueue             queue_;
+    QMutex                  drainMutex_;
+    QMutex                  waitMutex_;
+    QWaitCondition          wakeup_;
+    std::atomic<bool>       stopped_;
+    std::atomic<unsigned>   dropped_;
+    std::atomic<bool>       consuming_; // the queue has one consumer at a time
+
+private:
+    void drain ();
+
+protected:
+    void run ();
+
+public:
+    LoggerWriter ();
+
+    void push  (LoggerEngine::LoggerLevel level, const QString &message,
+                const char *file, int line);
+
+    // Writes all the queued events and then the given event on the calling
+    // thread, waiting for the writer if it's busy. Used for the critical
+    // and fatal events, which are never dropped.
+    void writeNow (const LoggerEvent &event);
+
+    // Drains the queue on the calling thread. It gives up if the writer
+    // can't be locked in time, so a dying process isn't held up by it.
+    void flush ();
+
+    // Writes the queued messages to the file descriptor with write() only,
+    // so it may be called from a crash handler. Best effort: nothing is
+    // written if the queue is being drained at the moment.
+    void flushToFd (int fd);
+
+    void stop  ();
+};
+
+#endif // LOGGERWRITER_H
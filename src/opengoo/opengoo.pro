@@ -36,7 +36,7 @@ LIBS += -L../extlibs/libs
 LIBS += -lAES
 
 !win32 {
-    LIBS += -lBox2D
+    LIBS += -lBox2D -lopenal
     freebsd-g++|freebsd-clang {
         LIBS += -lexecinfo
     }
@@ -47,12 +47,13 @@ win32: {
     LIBS += -lDbgHelp -lAdvapi32 -lpsapi -lUser32
 
     INCLUDEPATH += .
+    INCLUDEPATH += ../extlibs/openal/openal-soft-1.14/include
     CONFIG += console
 
     CONFIG(debug, debug|release) {
-        LIBS += -lBox2Dd
+        LIBS += -lBox2Dd -lopenald
     } else {
-        LIBS += -lBox2D
+        LIBS += -lBox2D -lopenal
     }
 
     msvc: {
@@ -100,6 +101,21 @@ HEADERS += \
     src/exit.h \
     src/progresswindow.h \
     src/og_layer.h \
+    src/og_buttonindex.h \
+    src/og_structurefreezer.h \
+    src/og_climbroutes.h \
+    src/og_groundcontacts.h \
+    src/og_particlesystem.h \
+    src/og_animation.h \
+    src/og_animationsystem.h \
+    src/og_scenelabel.h \
+    src/uiregistry.h \
+    src/og_scenecache.h \
+    src/og_renderstats.h \
+    src/og_primitivebatch.h \
+    src/og_rendersnapshot.h \
+    src/og_simulation.h \
+    src/og_levelvalidator.h \
     src/island.h \
     src/retrymenu.h \
     src/gamemenu.h \
@@ -140,6 +156,19 @@ SOURCES += \
     src/exit.cpp \
     src/progresswindow.cpp \
     src/og_layer.cpp \
+    src/og_buttonindex.cpp \
+    src/og_structurefreezer.cpp \
+    src/og_climbroutes.cpp \
+    src/og_groundcontacts.cpp \
+    src/og_particlesystem.cpp \
+    src/og_animation.cpp \
+    src/og_animationsystem.cpp \
+    src/og_scenelabel.cpp \
+    src/uiregistry.cpp \
+    src/og_scenecache.cpp \
+    src/og_primitivebatch.cpp \
+    src/og_simulation.cpp \
+    src/og_levelvalidator.cpp \
     src/island.cpp \
     src/retrymenu.cpp \
     src/gamemenu.cpp \
@@ -155,6 +184,7 @@ SOURCES += \
 
 include(src/GameEngine/GameEngine.files)
 include(src/PhysicsEngine/PhysicsEngine.files)
+include(src/SoundEngine/SoundEngine.files)
 include(src/OGLib/OGLib.files)
 include(src/GameConfiguration/GameConfiguration.files)
 
@@ -44,7 +44,7 @@ WOGBall* OGBallConfig::Parser()
         }
         else if (element.tagName() == "particles")
         {
-
+            obj->particles << CreateParticles_(element);
         }
         else if (element.tagName() == "splat")
         {
@@ -52,7 +52,7 @@ WOGBall* OGBallConfig::Parser()
         }
         else if (element.tagName() == "sound")
         {
-
+            obj->sound << CreateSound_(element);
         }
         else if (element.tagName() == "sinvariance")
         {
@@ -175,6 +175,27 @@ WOGBallDetachstrand* OGBallConfig::CreateDetachstrand_(
     return obj;
 }
 
+WOGBallSound OGBallConfig::CreateSound_(const QDomElement & element)
+{
+    WOGBallSound obj;
+
+    obj.event = element.attribute("event");
+    obj.id = element.attribute("id").split(",", QString::SkipEmptyParts);
+
+    return obj;
+}
+
+WOGBallParticles OGBallConfig::CreateParticles_(const QDomElement & element)
+{
+    WOGBallParticles obj;
+
+    obj.effect = element.attribute("effect");
+    obj.state = element.attribute("state").split(",", QString::SkipEmptyParts);
+    obj.overball = StringToBool(element.attribute("overball"));
+
+    return obj;
+}
+
 WOGBallShape* OGBallConfig::StringToShape(const QString & shape)
 {
     QStringList list = shape.split(",");
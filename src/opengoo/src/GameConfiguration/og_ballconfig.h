@@ -22,6 +22,8 @@ private:
     void _CreateLevelInteraction(WOGBall* ball);
     WOGBallStrand* CreateStrand_(const QDomElement & element);
     WOGBallDetachstrand* CreateDetachstrand_(const QDomElement & element);
+    WOGBallSound CreateSound_(const QDomElement & element);
+    WOGBallParticles CreateParticles_(const QDomElement & element);
     WOGBallShape* StringToShape(const QString & shape);
 };
 
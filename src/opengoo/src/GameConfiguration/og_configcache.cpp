@@ -0,0 +1,499 @@
+#include "og_configcache.h"
+#include "wog_material.h"
+#include "wog_resources.h"
+#include "wog_effects.h"
+#include "wog_text.h"
+#include "wog_ball.h"
+#include "logger.h"
+#include "GameEngine/metrics.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QThread>
+
+namespace
+{
+const quint32 MAGIC = 0x4347474F; // "OGGC"
+const quint32 VERSION = 2;        // must be changed with the structures
+
+QString ResolvePath(const QString &path)
+{
+    if (QFile::exists(path)) return path;
+    else if (QFile::exists(path + ".xml")) return path + ".xml";
+    else if (QFile::exists(path + ".bin")) return path + ".bin";
+
+    return QString();
+}
+
+// Materials
+
+void Write(QDataStream &out, const WOGMaterialList &data)
+{
+    out << qint32(data.material.size());
+
+    Q_FOREACH(const WOGMaterial* m, data.material)
+    {
+        out << m->id << m->friction << m->bounce << m->minbouncevel
+            << qint32(m->stickiness);
+    }
+}
+
+void Read(QDataStream &in, WOGMaterialList* data)
+{
+    qint32 n;
+    in >> n;
+
+    for (qint32 i = 0; i < n && in.status() == QDataStream::Ok; i++)
+    {
+        WOGMaterial* m = new WOGMaterial;
+        qint32 stickiness;
+        in >> m->id >> m->friction >> m->bounce >> m->minbouncevel
+           >> stickiness;
+        m->stickiness = stickiness;
+        data->material << m;
+    }
+}
+
+// Resources
+
+void Write(QDataStream &out, const WOGResources &data)
+{
+    out << qint32(data.group.size());
+
+    Q_FOREACH(const WOGResourceGroup* g, data.group)
+    {
+        out << g->id << qint32(g->resource.size());
+
+        Q_FOREACH(const WOGResource* r, g->resource)
+        {
+            out << qint32(r->type) << r->id << r->path;
+        }
+    }
+}
+
+void Read(QDataStream &in, WOGResources* data)
+{
+    qint32 n;
+    in >> n;
+
+    for (qint32 i = 0; i < n && in.status() == QDataStream::Ok; i++)
+    {
+        WOGResourceGroup* g = new WOGResourceGroup;
+        qint32 m;
+        in >> g->id >> m;
+
+        for (qint32 j = 0; j < m && in.status() == QDataStream::Ok; j++)
+        {
+            WOGResource* r = new WOGResource;
+            qint32 type;
+            in >> type >> r->id >> r->path;
+            r->type = WOGResource::Type(type);
+            g->resource << r;
+        }
+
+        data->group << g;
+    }
+}
+
+// Effects
+
+void Write(QDataStream &out, const WOGEffects &data)
+{
+    out << qint32(data.effect.size());
+
+    Q_FOREACH(const WOGParticleEffect* e, data.effect)
+    {
+        out << e->name << qint32(e->type) << qint32(e->maxparticles)
+            << e->rate << e->margin << qint32(e->particle.size());
+
+        Q_FOREACH(const WOGEffectParticle &p, e->particle)
+        {
+            out << p.image << p.scale << p.finalscale << p.rotation
+                << p.rotspeed << p.speed << p.movedir << p.movedirvar
+                << p.acceleration << p.lifespan << p.dampening << p.directed
+                << p.additive << p.fade;
+        }
+    }
+}
+
+void Read(QDataStream &in, WOGEffects* data)
+{
+    qint32 n;
+    in >> n;
+
+    for (qint32 i = 0; i < n && in.status() == QDataStream::Ok; i++)
+    {
+        WOGParticleEffect* e = new WOGParticleEffect;
+        qint32 type, maxparticles, m;
+        in >> e->name >> type >> maxparticles >> e->rate >> e->margin >> m;
+        e->type = WOGParticleEffect::Type(type);
+        e->maxparticles = maxparticles;
+
+        for (qint32 j = 0; j < m && in.status() == QDataStream::Ok; j++)
+        {
+            WOGEffectParticle p;
+            in >> p.image >> p.scale >> p.finalscale >> p.rotation
+               >> p.rotspeed >> p.speed >> p.movedir >> p.movedirvar
+               >> p.acceleration >> p.lifespan >> p.dampening >> p.directed
+               >> p.additive >> p.fade;
+            e->particle << p;
+        }
+
+        data->effect << e;
+    }
+}
+
+// Text
+
+void Write(QDataStream &out, const WOGText &data)
+{
+    out << data.language << qint32(data.string.size());
+
+    Q_FOREACH(const WOGString* s, data.string)
+    {
+        out << s->id << s->text;
+    }
+}
+
+void Read(QDataStream &in, WOGText* data)
+{
+    qint32 n;
+    in >> data->language >> n;
+
+    for (qint32 i = 0; i < n && in.status() == QDataStream::Ok; i++)
+    {
+        WOGString* s = new WOGString;
+        in >> s->id >> s->text;
+        data->string << s;
+    }
+}
+
+// Balls
+
+void Write(QDataStream &out, const WOGBallShape* shape)
+{
+    out << bool(shape);
+
+    if (!shape) return;
+
+    out << shape->type << shape->variation;
+
+    if (shape->type == "circle")
+    {
+        out << static_cast<const WOGCircleBall*>(shape)->radius;
+    }
+    else if (shape->type == "rectangle")
+    {
+        const WOGRectangleBall* rect =
+                static_cast<const WOGRectangleBall*>(shape);
+        out << rect->width << rect->height;
+    }
+}
+
+WOGBallShape* ReadShape(QDataStream &in)
+{
+    bool exists;
+    in >> exists;
+
+    if (!exists) return 0;
+
+    QString type;
+    float variation;
+    in >> type >> variation;
+
+    if (type == "circle")
+    {
+        WOGCircleBall* circle = new WOGCircleBall(0, variation);
+        in >> circle->radius;
+        return circle;
+    }
+    else if (type == "rectangle")
+    {
+        WOGRectangleBall* rect = new WOGRectangleBall(0, 0, variation);
+        in >> rect->width >> rect->height;
+        return rect;
+    }
+
+    return new WOGBallShape(type, variation);
+}
+
+void Write(QDataStream &out, const WOGBall &data)
+{
+    const WOGBallAttributes &a = data.attribute;
+
+    out << a.core.name;
+    Write(out, a.core.shape);
+    out << a.core.mass << qint32(a.core.strands) << a.core.material
+        << a.core.towermass << a.core.dragmass;
+
+    out << a.behaviour.jump;
+
+    out << a.movement.walkspeed << a.movement.climbspeed
+        << a.movement.speedvariance << a.movement.walkforce;
+
+    out << a.player.detachable << a.player.draggable << a.player.hingedrag
+        << a.player.fling;
+
+    out << a.level.suckable << a.cosmetic.blinkcolor << a.spawn;
+
+    out << bool(data.strand);
+
+    if (const WOGBallStrand* s = data.strand)
+    {
+        out << s->type << s->image << s->inactiveimage << s->minlen
+            << s->maxlen2 << s->maxlen1 << s->shrinklen << s->thickness
+            << s->springconstmax << s->springconstmin << s->walkable
+            << s->dampfac << s->maxforce << s->burnspeed << s->ignitedelay
+            << s->burntimage << s->fireparticles << s->rope << s->geom;
+    }
+
+    out << bool(data.detachstrand);
+
+    if (const WOGBallDetachstrand* d = data.detachstrand)
+    {
+        out << d->image << d->maxlen;
+    }
+
+    out << qint32(data.sound.size());
+
+    Q_FOREACH(const WOGBallSound &sound, data.sound)
+    {
+        out << sound.event << sound.id;
+    }
+
+    out << qint32(data.particles.size());
+
+    Q_FOREACH(const WOGBallParticles &particles, data.particles)
+    {
+        out << particles.effect << particles.state << particles.overball;
+    }
+}
+
+void Read(QDataStream &in, WOGBall* data)
+{
+    WOGBallAttributes &a = data->attribute;
+    qint32 strands;
+    bool exists;
+
+    in >> a.core.name;
+    a.core.shape = ReadShape(in);
+    in >> a.core.mass >> strands >> a.core.material
+       >> a.core.towermass >> a.core.dragmass;
+    a.core.strands = strands;
+
+    in >> a.behaviour.jump;
+
+    in >> a.movement.walkspeed >> a.movement.climbspeed
+       >> a.movement.speedvariance >> a.movement.walkforce;
+
+    in >> a.player.detachable >> a.player.draggable >> a.player.hingedrag
+       >> a.player.fling;
+
+    in >> a.level.suckable >> a.cosmetic.blinkcolor >> a.spawn;
+
+    in >> exists;
+
+    if (exists)
+    {
+        WOGBallStrand* s = new WOGBallStrand;
+        in >> s->type >> s->image >> s->inactiveimage >> s->minlen
+           >> s->maxlen2 >> s->maxlen1 >> s->shrinklen >> s->thickness
+           >> s->springconstmax >> s->springconstmin >> s->walkable
+           >> s->dampfac >> s->maxforce >> s->burnspeed >> s->ignitedelay
+           >> s->burntimage >> s->fireparticles >> s->rope >> s->geom;
+        data->strand = s;
+    }
+
+    in >> exists;
+
+    if (exists)
+    {
+        WOGBallDetachstrand* d = new WOGBallDetachstrand;
+        in >> d->image >> d->maxlen;
+        data->detachstrand = d;
+    }
+
+    qint32 n;
+    in >> n;
+
+    for (qint32 i = 0; i < n && in.status() == QDataStream::Ok; i++)
+    {
+        WOGBallSound sound;
+        in >> sound.event >> sound.id;
+        data->sound << sound;
+    }
+
+    in >> n;
+
+    for (qint32 i = 0; i < n && in.status() == QDataStream::Ok; i++)
+    {
+        WOGBallParticles particles;
+        in >> particles.effect >> particles.state >> particles.overball;
+        data->particles << particles;
+    }
+}
+
+template<class T> T* LoadEntry(const QString &entry)
+{
+    static og::Metrics::Counter* hits = og::Metrics::GetCounter("configcache.hits");
+    static og::Metrics::Counter* misses = og::Metrics::GetCounter("configcache.misses");
+
+    if (entry.isEmpty()) return 0;
+
+    QFile file(entry);
+
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        misses->Add();
+        return 0;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_0);
+
+    quint32 magic, version;
+    in >> magic >> version;
+
+    // Written by another version of the game, it's replaced by the entry
+    // stored after the miss
+    if (magic != MAGIC || version != VERSION)
+    {
+        file.remove();
+        misses->Add();
+        return 0;
+    }
+
+    T* data = new T;
+    Read(in, data);
+
+    if (in.status() != QDataStream::Ok)
+    {
+        logWarn("Corrupted config cache entry: " + entry);
+        delete data;
+        file.remove();
+        misses->Add();
+        return 0;
+    }
+
+    hits->Add();
+
+    return data;
+}
+
+template<class T> void StoreEntry(const QString &entry, const T* data)
+{
+    if (entry.isEmpty() || !data) return;
+
+    // Written under a temporary name, so a crash can't leave
+    // a truncated entry. The name is the thread's, as the worlds
+    // validated at once may store the same entry.
+    QString tmp = entry + "."
+            + QString::number(quintptr(QThread::currentThreadId())) + ".tmp";
+    QFile file(tmp);
+
+    if (!file.open(QIODevice::WriteOnly)) return;
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << MAGIC << VERSION;
+    Write(out, *data);
+
+    bool ok = (out.status() == QDataStream::Ok);
+    file.close();
+
+    if (ok)
+    {
+        QFile::remove(entry);
+        ok = QFile::rename(tmp, entry);
+    }
+
+    if (!ok)
+    {
+        logWarn("Could not write the config cache entry: " + entry);
+        QFile::remove(tmp);
+    }
+}
+}
+
+QString OGConfigCache::directory_;
+
+void OGConfigCache::SetDirectory(const QString &path)
+{
+    if (!QDir().mkpath(path))
+    {
+        logWarn("Could not create the config cache: " + path);
+        return;
+    }
+
+    directory_ = path;
+}
+
+WOGMaterialList* OGConfigCache::LoadMaterials(const QString &path)
+{
+    return LoadEntry<WOGMaterialList>(_GetEntryName(path, "materials"));
+}
+
+WOGResources* OGConfigCache::LoadResources(const QString &path)
+{
+    return LoadEntry<WOGResources>(_GetEntryName(path, "resources"));
+}
+
+WOGEffects* OGConfigCache::LoadEffects(const QString &path)
+{
+    return LoadEntry<WOGEffects>(_GetEntryName(path, "effects"));
+}
+
+WOGText* OGConfigCache::LoadText(const QString &path, const QString &language)
+{
+    return LoadEntry<WOGText>(_GetEntryName(path, "text", language));
+}
+
+WOGBall* OGConfigCache::LoadBall(const QString &path)
+{
+    return LoadEntry<WOGBall>(_GetEntryName(path, "ball"));
+}
+
+void OGConfigCache::Store(const QString &path, const WOGMaterialList* data)
+{
+    StoreEntry(_GetEntryName(path, "materials"), data);
+}
+
+void OGConfigCache::Store(const QString &path, const WOGResources* data)
+{
+    StoreEntry(_GetEntryName(path, "resources"), data);
+}
+
+void OGConfigCache::Store(const QString &path, const WOGEffects* data)
+{
+    StoreEntry(_GetEntryName(path, "effects"), data);
+}
+
+void OGConfigCache::Store(const QString &path, const WOGText* data
+                          , const QString &language)
+{
+    StoreEntry(_GetEntryName(path, "text", language), data);
+}
+
+void OGConfigCache::Store(const QString &path, const WOGBall* data)
+{
+    StoreEntry(_GetEntryName(path, "ball"), data);
+}
+
+QString OGConfigCache::_GetEntryName(const QString &path, const char* type
+                                     , const QString &variant)
+{
+    if (directory_.isEmpty()) return QString();
+
+    QFile file(ResolvePath(path));
+
+    if (!file.open(QIODevice::ReadOnly)) return QString();
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QByteArray(type));
+    hash.addData(variant.toUtf8());
+    hash.addData(file.readAll());
+
+    return directory_ + "/" + hash.result().toHex() + ".cfg";
+}
@@ -0,0 +1,67 @@
+#ifndef OG_CONFIGCACHE_H
+#define OG_CONFIGCACHE_H
+
+#include <QString>
+
+struct WOGMaterialList;
+class WOGResources;
+struct WOGEffects;
+struct WOGText;
+struct WOGBall;
+
+// Persistent cache of the parsed configuration files. An entry is keyed by
+// the content hash of the source file (and a variant, e.g. the language of
+// a text file), so an edited file is parsed again and a warm start doesn't
+// touch XML at all. The structures are serialized with QDataStream.
+class OGConfigCache
+{
+public:
+    // The cache is disabled until the directory is set
+    static void SetDirectory(const QString &path);
+
+    // Return 0 if there is no valid entry for the file
+    static WOGMaterialList* LoadMaterials(const QString &path);
+    static WOGResources* LoadResources(const QString &path);
+    static WOGEffects* LoadEffects(const QString &path);
+    static WOGText* LoadText(const QString &path, const QString &language);
+    static WOGBall* LoadBall(const QString &path);
+
+    static void Store(const QString &path, const WOGMaterialList* data);
+    static void Store(const QString &path, const WOGResources* data);
+    static void Store(const QString &path, const WOGEffects* data);
+    static void Store(const QString &path, const WOGText* data
+                      , const QString &language);
+    static void Store(const QString &path, const WOGBall* data);
+
+    // Overloads for the LoadConf template of OGWorld
+    static void Load(const QString &path, WOGMaterialList** data)
+    {
+        *data = LoadMaterials(path);
+    }
+
+    static void Load(const QString &path, WOGEffects** data)
+    {
+        *data = LoadEffects(path);
+    }
+
+    static void Load(const QString &path, WOGBall** data)
+    {
+        *data = LoadBall(path);
+    }
+
+    // The types which aren't cached
+    template<class T> static void Load(const QString &, T** data)
+    {
+        *data = 0;
+    }
+
+    template<class T> static void Store(const QString &, const T*) {}
+
+private:
+    static QString directory_;
+
+    static QString _GetEntryName(const QString &path, const char* type
+                                 , const QString &variant = QString());
+};
+
+#endif // OG_CONFIGCACHE_H
@@ -1,7 +1,5 @@
 #include "og_effectconfig.h"
 
-#include <QDebug>
-
 OGEffectConfig::OGEffectConfig(const QString & filename)
     : OGXmlConfig(filename)
 {
@@ -10,7 +8,79 @@ OGEffectConfig::OGEffectConfig(const QString & filename)
 
 WOGEffects* OGEffectConfig::Parser()
 {
-    qWarning() << __FUNCTION__ << "is UNIMPLEMENTED!";
+    WOGEffects* obj = new WOGEffects;
+
+    for (QDomNode n = rootElement.firstChild(); !n.isNull(); n = n.nextSibling())
+    {
+        QDomElement element = n.toElement();
+
+        if (element.tagName() == "particleeffect"
+                || element.tagName() == "ambientparticleeffect")
+        {
+            WOGParticleEffect* effect = CreateEffect_(element);
+
+            // The template of the file has empty effects
+            if (effect->name.isEmpty()) delete effect;
+            else obj->effect << effect;
+        }
+    }
+
+    return obj;
+}
+
+WOGParticleEffect* OGEffectConfig::CreateEffect_(const QDomElement & element)
+{
+    WOGParticleEffect* obj = new WOGParticleEffect;
+
+    obj->name = element.attribute("name");
+    obj->type = (element.tagName() == "ambientparticleeffect")
+                ? WOGParticleEffect::AMBIENT : WOGParticleEffect::POINT;
+    obj->maxparticles = element.attribute("maxparticles").toInt();
+    obj->rate = element.attribute("rate").toDouble();
+    obj->margin = element.attribute("margin").toDouble();
+
+    for (QDomNode n = element.firstChild(); !n.isNull(); n = n.nextSibling())
+    {
+        QDomElement e = n.toElement();
+
+        if (e.tagName() == "particle") obj->particle << CreateParticle_(e);
+    }
+
+    return obj;
+}
+
+WOGEffectParticle OGEffectConfig::CreateParticle_(const QDomElement & element)
+{
+    WOGEffectParticle obj;
+
+    obj.image = element.attribute("image").split(",", QString::SkipEmptyParts);
+    obj.scale = StringToRange_(element.attribute("scale"), 1.0f);
+    obj.finalscale = element.hasAttribute("finalscale")
+                     ? element.attribute("finalscale").toDouble() : -1.0f;
+    obj.rotation = StringToRange_(element.attribute("rotation"));
+    obj.rotspeed = StringToRange_(element.attribute("rotspeed"));
+    obj.speed = StringToRange_(element.attribute("speed"));
+    obj.movedir = element.attribute("movedir").toDouble();
+    obj.movedirvar = element.attribute("movedirvar").toDouble();
+    obj.acceleration = StringToPoint(element.attribute("acceleration"));
+    obj.lifespan = StringToRange_(element.attribute("lifespan"));
+    obj.dampening = element.attribute("dampening").toDouble();
+    obj.directed = StringToBool(element.attribute("directed"));
+    obj.additive = StringToBool(element.attribute("additive"));
+    obj.fade = StringToBool(element.attribute("fade"));
+
+    return obj;
+}
+
+// "min,max" or a single value; value if the attribute isn't set
+QPointF OGEffectConfig::StringToRange_(const QString & range, float value)
+{
+    QStringList list = range.split(",");
+
+    if (list.size() == 2)
+        return QPointF(list.at(0).toDouble(), list.at(1).toDouble());
+
+    if (!range.isEmpty()) value = range.toDouble();
 
-    return 0;
+    return QPointF(value, value);
 }
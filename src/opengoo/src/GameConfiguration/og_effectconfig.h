@@ -10,6 +10,11 @@ public:
     OGEffectConfig(const QString & filename);
 
     WOGEffects* Parser();
+
+private:
+    WOGParticleEffect* CreateEffect_(const QDomElement & element);
+    WOGEffectParticle CreateParticle_(const QDomElement & element);
+    QPointF StringToRange_(const QString & range, float value = 0.0f);
 };
 
 #endif // OG_EFFECTCONFIG_H
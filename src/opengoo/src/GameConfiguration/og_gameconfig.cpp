@@ -11,6 +11,10 @@ OGGameConfig::OGGameConfig(const QString & filename)
 OGConfig OGGameConfig::Parser()
 {
     OGConfig config;
+    config.refreshrate = 0;
+    config.framepacing = "vsync";
+    config.maxframesteps = 4;
+
     QDomNode node = rootElement.firstChild();
 
     while (!node.isNull())
@@ -45,6 +49,14 @@ OGConfig OGGameConfig::Parser()
             {
                 config.refreshrate = domElement.attribute("value").toInt();
             }
+            else if (attribute == "framepacing")
+            {
+                config.framepacing = domElement.attribute("value");
+            }
+            else if (attribute == "maxframesteps")
+            {
+                config.maxframesteps = domElement.attribute("value").toInt();
+            }
         }
 
         node = node.nextSibling();
@@ -87,6 +99,21 @@ void OGGameConfig::Create(OGConfig &config)
 
     stream.writeEndElement(); // end fullscreen
 
+    stream.writeStartElement("param");
+    stream.writeAttribute("name", "refreshrate");
+    stream.writeAttribute("value",  QString::number(config.refreshrate));
+    stream.writeEndElement(); // end refreshrate
+
+    stream.writeStartElement("param");
+    stream.writeAttribute("name", "framepacing");
+    stream.writeAttribute("value",  config.framepacing);
+    stream.writeEndElement(); // end framepacing
+
+    stream.writeStartElement("param");
+    stream.writeAttribute("name", "maxframesteps");
+    stream.writeAttribute("value",  QString::number(config.maxframesteps));
+    stream.writeEndElement(); // end maxframesteps
+
     stream.writeEndElement(); // end config
 
     stream.writeEndDocument();
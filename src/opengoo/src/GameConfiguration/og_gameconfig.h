@@ -8,6 +8,8 @@ struct OGConfig
     int screen_width;
     int screen_height;
     int refreshrate;
+    QString framepacing;   // vsync, fixed or uncapped
+    int maxframesteps;     // simulation steps to catch up after a long frame
     bool fullscreen;
     QString language;
 };
@@ -58,6 +58,10 @@ WOGLevel* OGLevelConfig::Parser()
         {
             level->strand << CreateStrand(domElement);
         }
+        else if (domElement.tagName() == "solver")
+        {
+            level->solver = CreateSolver(domElement);
+        }
 
         node = node.nextSibling();
     }
@@ -155,3 +159,23 @@ WOGStrand* OGLevelConfig::CreateStrand(const QDomElement &element)
 
     return obj;
 }
+
+// The attributes which aren't set keep their defaults
+WOGSolver OGLevelConfig::CreateSolver(const QDomElement &element)
+{
+    WOGSolver obj;
+    obj.minvelocity = element.attribute("minvelocity"
+                                        , QString::number(obj.minvelocity)).toInt();
+    obj.maxvelocity = element.attribute("maxvelocity"
+                                        , QString::number(obj.maxvelocity)).toInt();
+    obj.minposition = element.attribute("minposition"
+                                        , QString::number(obj.minposition)).toInt();
+    obj.maxposition = element.attribute("maxposition"
+                                        , QString::number(obj.maxposition)).toInt();
+    obj.maxsubsteps = element.attribute("maxsubsteps"
+                                        , QString::number(obj.maxsubsteps)).toInt();
+    obj.budget = element.attribute("budget"
+                                   , QString::number(obj.budget)).toFloat();
+
+    return obj;
+}
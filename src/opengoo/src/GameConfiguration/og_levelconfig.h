@@ -18,6 +18,7 @@ class OGLevelConfig : public OGXmlConfig
         WOGBallInstance* CreateBallInstance(const QDomElement &element);
         WOGPipe* CreatePipe(const QDomElement &element);
         WOGStrand* CreateStrand(const QDomElement &element);
+        WOGSolver CreateSolver(const QDomElement &element);
         QPointF CreateVertex(const QDomElement &element);
 };
 
@@ -115,7 +115,7 @@ WOGLabel* OGSceneConfig::CreateLabel(const QDomElement &element)
 
     obj->align = element.attribute("align");
     obj->rotation = element.attribute("rotation").toDouble();
-    obj->scale = element.attribute("scale").toDouble();
+    obj->scale = element.attribute("scale", "1").toDouble();
     obj->overlay = StringToBool(element.attribute("overlay"));
     obj->screenspace = StringToBool(element.attribute("screenspace"));
     obj->font = element.attribute("font");
@@ -143,7 +143,7 @@ WOGSceneLayer* OGSceneConfig::CreateSceneLayer(const QDomElement &element)
 
     obj->image = element.attribute("image");
     obj->anim = element.attribute("anim");
-    obj->animspeed = element.attribute("animspeed").toDouble();
+    obj->animspeed = element.attribute("animspeed", "1").toDouble();
 
     return obj;
 }
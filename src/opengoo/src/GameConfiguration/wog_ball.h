@@ -4,8 +4,12 @@
 // Ball definition file
 // source http://goofans.com/developers/game-file-formats/balls-xml
 
+#include "GameEngine/memorytracker.h"
+
 #include <QString>
+#include <QStringList>
 #include <QColor>
+#include <QList>
 
 struct WOGBallShape
 {
@@ -143,11 +147,27 @@ struct WOGBallDetachstrand
     float maxlen;
 };
 
-struct WOGBall
+struct WOGBallSound
+{
+    QString event;
+    QStringList id; // one of them is played at random
+};
+
+// An effect of fx.xml shown while the ball is in one of the states
+struct WOGBallParticles
+{
+    QString effect;
+    QStringList state;
+    bool overball;
+};
+
+struct WOGBall : og::Tracked<WOGBall, og::MemoryTracker::CONFIG>
 {
     WOGBallAttributes attribute;
     WOGBallStrand* strand;
     WOGBallDetachstrand* detachstrand;
+    QList<WOGBallSound> sound;
+    QList<WOGBallParticles> particles;
 
     WOGBall() : strand(0), detachstrand(0)  {}
     ~WOGBall()
@@ -1,12 +1,67 @@
 #ifndef WOG_EFFECTS_H
 #define WOG_EFFECTS_H
 
+#include "GameEngine/memorytracker.h"
+
 #include <QDebug>
+#include <QList>
+#include <QPointF>
+#include <QStringList>
+
+// Source http://goofans.com/developers/game-file-formats/fx-xml
+//
+// The ranges are stored as QPointF, x is the minimum and y the maximum.
+// The speeds are in pixels and the rotation speeds in radians per frame
+// of 1/60 s; the directions and the rotations are in degrees.
+
+struct WOGEffectParticle
+{
+    QStringList image; // one of them at random
+    QPointF scale;
+    float finalscale;  // negative if the scale doesn't change
+    QPointF rotation;
+    QPointF rotspeed;
+    QPointF speed;
+    float movedir;
+    float movedirvar;
+    QPointF acceleration;
+    QPointF lifespan;  // in seconds, 0 if the particle lives forever
+    float dampening;   // the part of the speed lost every frame
+    bool directed;     // the image is turned along the movement
+    bool additive;
+    bool fade;
+};
 
-struct WOGEffects
+struct WOGParticleEffect
 {
+    enum Type { POINT, AMBIENT };
+
+    QString name;
+    Type type;
+    int maxparticles;  // 0 if not set
+    float rate;        // particles per frame, point effects only
+    float margin;      // ambient effects only
+    QList<WOGEffectParticle> particle;
+};
+
+struct WOGEffects : og::Tracked<WOGEffects, og::MemoryTracker::CONFIG>
+{
+    QList<WOGParticleEffect*> effect;
+
+    const WOGParticleEffect* GetEffect(const QString &name) const
+    {
+        Q_FOREACH(const WOGParticleEffect* e, effect)
+        {
+            if (e->name == name) return e;
+        }
+
+        return 0;
+    }
+
     ~WOGEffects()
     {
+        while (!effect.isEmpty()) { delete effect.takeFirst(); }
+
         qDebug("WOGEffects: End");
     }
 };
@@ -4,6 +4,8 @@
 #include "wog_exit.h"
 #include "wog_pipe.h"
 
+#include "GameEngine/memorytracker.h"
+
 #include <QPointF>
 #include <QString>
 #include <QList>
@@ -48,7 +50,25 @@ struct WOGStrand
     QString gb2;
 };
 
-struct WOGLevel
+// <solver> of the level file, the bounds of the physics quality.
+// The minimums keep the level stable, the budget is in milliseconds.
+struct WOGSolver
+{
+    int minvelocity;
+    int maxvelocity;
+    int minposition;
+    int maxposition;
+    int maxsubsteps;
+    float budget;
+
+    WOGSolver()
+        : minvelocity(4), maxvelocity(8), minposition(2), maxposition(3)
+        , maxsubsteps(1), budget(4)
+    {
+    }
+};
+
+struct WOGLevel : og::Tracked<WOGLevel, og::MemoryTracker::CONFIG>
 {
     int ballsrequired;
     bool letterboxed;
@@ -65,6 +85,7 @@ struct WOGLevel
     WOGLevelExit* levelexit;
     QList<WOGStrand*> strand;
     WOGPipe* pipe;
+    WOGSolver solver;
 
     WOGLevel() : levelexit(nullptr), pipe(nullptr) { }
     ~WOGLevel();
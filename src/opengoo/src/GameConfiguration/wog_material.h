@@ -1,6 +1,8 @@
 #ifndef WOG_MATERIAL_H
 #define WOG_MATERIAL_H
 
+#include "GameEngine/memorytracker.h"
+
 #include <QList>
 #include <QString>
 
@@ -13,7 +15,7 @@ struct WOGMaterial
     int stickiness;
 };
 
-struct WOGMaterialList
+struct WOGMaterialList : og::Tracked<WOGMaterialList, og::MemoryTracker::CONFIG>
 {
     QList<WOGMaterial*> material;
 
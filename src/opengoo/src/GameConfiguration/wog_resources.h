@@ -1,6 +1,8 @@
 #ifndef WOG_RESOURCES_H
 #define WOG_RESOURCES_H
 
+#include "GameEngine/memorytracker.h"
+
 #include <QString>
 #include <QList>
 #include <QDebug>
@@ -22,7 +24,7 @@ struct WOGResourceGroup
     ~WOGResourceGroup();
 };
 
-class WOGResources
+class WOGResources : og::Tracked<WOGResources, og::MemoryTracker::CONFIG>
 {
 public:
     QList<WOGResourceGroup*> group;
@@ -36,6 +38,18 @@ public:
         return GetResource(WOGResource::IMAGE, id, groupid);
     }
 
+    QString GetSound(const QString & id
+                     , const QString & groupid=QString()) const
+    {
+        return GetResource(WOGResource::SOUND, id, groupid);
+    }
+
+    QString GetFont(const QString & id
+                    , const QString & groupid=QString()) const
+    {
+        return GetResource(WOGResource::FONT, id, groupid);
+    }
+
     ~WOGResources();
 };
 
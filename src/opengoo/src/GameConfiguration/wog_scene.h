@@ -5,6 +5,8 @@
 #include "wog_vobject.h"
 #include "wog_circle.h"
 
+#include "GameEngine/memorytracker.h"
+
 #include <QSizeF>
 
 struct WOGLabel
@@ -106,7 +108,7 @@ struct WOGCompositeGeom : public WOGPObject
     ~WOGCompositeGeom();
 };
 
-struct WOGScene
+struct WOGScene : og::Tracked<WOGScene, og::MemoryTracker::CONFIG>
 {
     float minx;
     float miny;
@@ -1,6 +1,8 @@
 #ifndef WOG_TEXT_H
 #define WOG_TEXT_H
 
+#include "GameEngine/memorytracker.h"
+
 #include <QString>
 #include <QList>
 
@@ -10,7 +12,7 @@ struct WOGString
     QString text;
 };
 
-struct WOGText
+struct WOGText : og::Tracked<WOGText, og::MemoryTracker::CONFIG>
 {
     QString language;
     QList<WOGString*> string;
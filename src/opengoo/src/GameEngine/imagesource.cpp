@@ -1,20 +1,90 @@
 #include <QPainter>
+#include <QtCore/qmath.h>
 
 #include "imagesource.h"
+#include "texturecache.h"
 
 namespace og
 {
+ImageSource::ImageSource(const QString& a_filename)
+    : m_image(QPixmap::fromImage(TextureCache::Load(a_filename)))
+    , m_memory(MemoryTracker::IMAGES)
+{
+    m_memory.Resize(qint64(m_image.width()) * m_image.height() * 4);
+}
+
 void ImageSource::Render(QPainter& a_painter,
             const QRectF& a_target,
-            const QRectF& a_source)
+            const QRectF& a_source,
+            float a_scale)
 {
-    a_painter.drawPixmap(a_target, m_image, a_source);
+    int level = SelectLevel(a_scale);
+
+    if (level == 0)
+    {
+        a_painter.drawPixmap(a_target, m_image, a_source);
+        return;
+    }
+
+    qreal k = 1.0 / (1 << level);
+    QRectF source(a_source.x() * k, a_source.y() * k,
+                  a_source.width() * k, a_source.height() * k);
+
+    a_painter.drawPixmap(a_target, GetLevel(level), source);
 }
 
 void ImageSource::Render(QPainter& a_painter,
             const QPointF& a_pos,
-            const QRectF& a_source)
+            const QRectF& a_source,
+            float a_scale)
+{
+    if (SelectLevel(a_scale) == 0)
+    {
+        a_painter.drawPixmap(a_pos, m_image, a_source);
+        return;
+    }
+
+    Render(a_painter, QRectF(a_pos, a_source.size()), a_source, a_scale);
+}
+
+const QPixmap& ImageSource::GetPixmap(float a_scale, qreal* a_k)
+{
+    int level = SelectLevel(a_scale);
+
+    *a_k = 1.0 / (1 << level);
+
+    return level == 0 ? m_image : GetLevel(level);
+}
+
+// The smallest level which is still drawn at its size or minified, by
+// less than 2x, so a level is never magnified
+int ImageSource::SelectLevel(float a_scale)
 {
-    a_painter.drawPixmap(a_pos, m_image, a_source);
+    if (a_scale <= 0.0f || a_scale >= 0.5f)
+        return 0;
+
+    int level = qFloor(-qLn(a_scale) / M_LN2);
+    int size = qMin(m_image.width(), m_image.height());
+
+    while (level > 0 && (size >> level) < 1)
+        --level;
+
+    return level;
+}
+
+const QPixmap& ImageSource::GetLevel(int a_level)
+{
+    while (m_levels.size() < a_level)
+    {
+        const QPixmap& prev = m_levels.isEmpty() ? m_image : m_levels.last();
+        QImage image = prev.toImage().scaled(qMax(prev.width() / 2, 1),
+                                             qMax(prev.height() / 2, 1),
+                                             Qt::IgnoreAspectRatio,
+                                             Qt::SmoothTransformation);
+        m_levels.append(QPixmap::fromImage(image));
+        m_memory.Resize(m_memory.Size() + qint64(image.width()) * image.height() * 4);
+    }
+
+    return m_levels.at(a_level - 1);
 }
 }
@@ -1,33 +1,51 @@
 #pragma once
 
 #include <QPixmap>
+#include <QVector>
+
+#include "memorytracker.h"
 
 class QRectF;
 class QPointF;
 
 namespace og
 {
+// An image with a lazily built chain of mip levels. Each level is half the
+// size of the previous one; a level is created the first time the image is
+// drawn small enough to use it.
 class ImageSource
 {
     QPixmap m_image;
+    QVector<QPixmap> m_levels; // 1/2, 1/4, ...
+    MemoryTracker::Block m_memory;
+
+    int SelectLevel(float a_scale);
+    const QPixmap& GetLevel(int a_level);
 
 public:
     ImageSource()
+        : m_memory(MemoryTracker::IMAGES)
     {
     }
 
-    ImageSource(const QString& a_filename)
-        : m_image(a_filename)
-    {
-    }
+    // The file is decoded through the TextureCache
+    ImageSource(const QString& a_filename);
 
+    // a_scale is the size of one image pixel on the device, i.e.
+    // the camera zoom multiplied by the scale of the sprite
     void Render(QPainter& a_painter,
                 const QRectF& a_target,
-                const QRectF& a_source);
+                const QRectF& a_source,
+                float a_scale = 1.0f);
 
     void Render(QPainter& a_painter,
                 const QPointF& a_pos,
-                const QRectF& a_source);
+                const QRectF& a_source,
+                float a_scale = 1.0f);
+
+    // The level to draw at a_scale, e.g. for a batch of fragments;
+    // *a_k is its size relative to the image
+    const QPixmap& GetPixmap(float a_scale, qreal* a_k);
 
     int GetWidth() const
     {
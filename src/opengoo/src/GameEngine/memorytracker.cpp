@@ -0,0 +1,104 @@
+#include "memorytracker.h"
+#include "metrics.h"
+#include "logger.h"
+
+namespace og
+{
+std::atomic<qint64> MemoryTracker::s_objects[MemoryTracker::TAG_COUNT];
+std::atomic<qint64> MemoryTracker::s_bytes[MemoryTracker::TAG_COUNT];
+
+MemoryTracker::Block& MemoryTracker::Block::operator=(const Block& a_other)
+{
+    Released(m_tag, m_bytes);
+    m_tag = a_other.m_tag;
+    m_bytes = a_other.m_bytes;
+    Allocated(m_tag, m_bytes);
+
+    return *this;
+}
+
+void MemoryTracker::Block::Resize(qint64 a_bytes)
+{
+    s_bytes[m_tag].fetch_add(a_bytes - m_bytes, std::memory_order_relaxed);
+    m_bytes = a_bytes;
+}
+
+void MemoryTracker::Allocated(Tag a_tag, qint64 a_bytes)
+{
+    s_objects[a_tag].fetch_add(1, std::memory_order_relaxed);
+    s_bytes[a_tag].fetch_add(a_bytes, std::memory_order_relaxed);
+}
+
+void MemoryTracker::Released(Tag a_tag, qint64 a_bytes)
+{
+    s_objects[a_tag].fetch_sub(1, std::memory_order_relaxed);
+    s_bytes[a_tag].fetch_sub(a_bytes, std::memory_order_relaxed);
+}
+
+MemoryTracker::Usage MemoryTracker::GetUsage()
+{
+    Usage usage;
+
+    for (int i = 0; i < TAG_COUNT; i++)
+    {
+        usage.objects[i] = s_objects[i].load(std::memory_order_relaxed);
+        usage.bytes[i] = s_bytes[i].load(std::memory_order_relaxed);
+    }
+
+    return usage;
+}
+
+bool MemoryTracker::Report(const Usage& a_since, const QString& a_title)
+{
+    Usage usage = GetUsage();
+    bool ok = true;
+
+    logInfo(a_title);
+
+    for (int i = 0; i < TAG_COUNT; i++)
+    {
+        Tag tag = Tag(i);
+        QString name = GetName(tag);
+
+        logInfof("  %1: %2 objects (%3), %4 KB (%5)"
+                 , name
+                 , usage.objects[i], usage.objects[i] - a_since.objects[i]
+                 , usage.bytes[i] / 1024, (usage.bytes[i] - a_since.bytes[i]) / 1024);
+
+        Metrics::GetGauge("memory." + name + ".objects")->Set(usage.objects[i]);
+        Metrics::GetGauge("memory." + name + ".bytes")->Set(usage.bytes[i]);
+
+        if (IsLevelScoped(tag) && usage.objects[i] != 0)
+        {
+            logErrorf("%1 objects of %2 outlived the level", usage.objects[i], name);
+            ok = false;
+        }
+    }
+
+    return ok;
+}
+
+bool MemoryTracker::IsLevelScoped(Tag a_tag)
+{
+    return a_tag == PHYSICS || a_tag == SPRITES || a_tag == UI;
+}
+
+const char* MemoryTracker::GetName(Tag a_tag)
+{
+    switch (a_tag)
+    {
+    case CONFIG:
+        return "config";
+    case PHYSICS:
+        return "physics";
+    case SPRITES:
+        return "sprites";
+    case IMAGES:
+        return "images";
+    case UI:
+        return "ui";
+    default:
+        return "unknown";
+    }
+}
+}
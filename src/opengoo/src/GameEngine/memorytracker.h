@@ -0,0 +1,84 @@
+#pragma once
+
+#include <QString>
+
+#include <atomic>
+
+namespace og
+{
+// Counts the live objects and bytes of the engine by subsystem. The counts
+// are kept with relaxed atomics, so tracked objects can be created on any
+// thread. OGWorld takes a snapshot when a level is loaded and reports the
+// difference when the level is closed; the level-scoped tags have to be
+// back to zero by then.
+class MemoryTracker
+{
+public:
+    enum Tag
+    {
+        CONFIG,
+        PHYSICS,
+        SPRITES,
+        IMAGES,
+        UI,
+        TAG_COUNT
+    };
+
+    struct Usage
+    {
+        qint64 objects[TAG_COUNT];
+        qint64 bytes[TAG_COUNT];
+    };
+
+    // A block of memory which is accounted for as long as it's alive,
+    // e.g. the pixels of an image. A copy is accounted for separately.
+    class Block
+    {
+    public:
+        explicit Block(Tag a_tag) : m_tag(a_tag), m_bytes(0) { Allocated(m_tag, 0); }
+        Block(const Block& a_other) : m_tag(a_other.m_tag), m_bytes(a_other.m_bytes)
+        {
+            Allocated(m_tag, m_bytes);
+        }
+        ~Block() { Released(m_tag, m_bytes); }
+
+        Block& operator=(const Block& a_other);
+
+        void Resize(qint64 a_bytes);
+        qint64 Size() const { return m_bytes; }
+
+    private:
+        Tag m_tag;
+        qint64 m_bytes;
+    };
+
+    static void Allocated(Tag a_tag, qint64 a_bytes);
+    static void Released(Tag a_tag, qint64 a_bytes);
+
+    static Usage GetUsage();
+
+    // Logs the difference to the earlier usage and publishes the current
+    // usage as the memory.* metrics. Returns false if a level-scoped tag
+    // still has live objects.
+    static bool Report(const Usage& a_since, const QString& a_title);
+
+    static bool IsLevelScoped(Tag a_tag);
+    static const char* GetName(Tag a_tag);
+
+private:
+    static std::atomic<qint64> s_objects[TAG_COUNT];
+    static std::atomic<qint64> s_bytes[TAG_COUNT];
+};
+
+// Base class which accounts for every instance of T under the tag
+template<class T, MemoryTracker::Tag t_tag>
+class Tracked
+{
+protected:
+    Tracked() { MemoryTracker::Allocated(t_tag, sizeof(T)); }
+    Tracked(const Tracked&) { MemoryTracker::Allocated(t_tag, sizeof(T)); }
+    ~Tracked() { MemoryTracker::Released(t_tag, sizeof(T)); }
+
+    Tracked& operator=(const Tracked&) { return *this; }
+};
+}
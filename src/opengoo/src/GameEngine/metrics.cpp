@@ -0,0 +1,215 @@
+#include "metrics.h"
+#include "logger.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include <map>
+
+#ifdef Q_OS_UNIX
+#include <csignal>
+#endif
+
+namespace
+{
+using og::Metrics;
+
+struct Registry
+{
+    QMutex mutex;
+    std::map<QString, std::unique_ptr<Metrics::Counter>> counters;
+    std::map<QString, std::unique_ptr<Metrics::Gauge>> gauges;
+    std::map<QString, std::unique_ptr<Metrics::Histogram>> histograms;
+    QDateTime started;
+
+    Registry() : started(QDateTime::currentDateTime()) {}
+};
+
+Registry& GetRegistry()
+{
+    static Registry registry;
+
+    return registry;
+}
+}
+
+namespace og
+{
+QString Metrics::s_directory;
+std::atomic<bool> Metrics::s_dumpRequested(false);
+
+Metrics::Histogram::Histogram(const QVector<qint64>& a_bounds)
+    : m_bounds(a_bounds)
+    , m_buckets(new std::atomic<qint64>[a_bounds.size() + 1])
+    , m_count(0)
+    , m_sum(0)
+{
+    for (int i = 0; i <= m_bounds.size(); i++)
+        m_buckets[i].store(0, std::memory_order_relaxed);
+}
+
+void Metrics::Histogram::Record(qint64 a_value)
+{
+    int i = 0;
+
+    while (i < m_bounds.size() && a_value > m_bounds[i])
+        i++;
+
+    m_buckets[i].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(a_value, std::memory_order_relaxed);
+}
+
+qint64 Metrics::Histogram::BucketCount(int a_bucket) const
+{
+    return m_buckets[a_bucket].load(std::memory_order_relaxed);
+}
+
+Metrics::Counter* Metrics::GetCounter(const QString& a_name)
+{
+    Registry& registry = GetRegistry();
+    QMutexLocker lock(&registry.mutex);
+    std::unique_ptr<Counter>& counter = registry.counters[a_name];
+
+    if (!counter)
+        counter.reset(new Counter);
+
+    return counter.get();
+}
+
+Metrics::Gauge* Metrics::GetGauge(const QString& a_name)
+{
+    Registry& registry = GetRegistry();
+    QMutexLocker lock(&registry.mutex);
+    std::unique_ptr<Gauge>& gauge = registry.gauges[a_name];
+
+    if (!gauge)
+        gauge.reset(new Gauge);
+
+    return gauge.get();
+}
+
+Metrics::Histogram* Metrics::GetHistogram(const QString& a_name, const QVector<qint64>& a_bounds)
+{
+    Registry& registry = GetRegistry();
+    QMutexLocker lock(&registry.mutex);
+    std::unique_ptr<Histogram>& histogram = registry.histograms[a_name];
+
+    if (!histogram)
+        histogram.reset(new Histogram(a_bounds));
+
+    return histogram.get();
+}
+
+QByteArray Metrics::ToJson()
+{
+    Registry& registry = GetRegistry();
+    QMutexLocker lock(&registry.mutex);
+
+    QJsonObject counters;
+
+    for (auto it = registry.counters.begin(); it != registry.counters.end(); ++it)
+        counters.insert(it->first, double(it->second->Value()));
+
+    QJsonObject gauges;
+
+    for (auto it = registry.gauges.begin(); it != registry.gauges.end(); ++it)
+        gauges.insert(it->first, it->second->Value());
+
+    QJsonObject histograms;
+
+    for (auto it = registry.histograms.begin(); it != registry.histograms.end(); ++it)
+    {
+        const Histogram& histogram = *it->second;
+        QJsonArray buckets;
+
+        for (int i = 0; i <= histogram.Bounds().size(); i++)
+        {
+            QJsonObject bucket;
+
+            if (i < histogram.Bounds().size())
+                bucket.insert("le", double(histogram.Bounds()[i]));
+            else
+                bucket.insert("le", QString("inf"));
+
+            bucket.insert("count", double(histogram.BucketCount(i)));
+            buckets.append(bucket);
+        }
+
+        QJsonObject obj;
+        obj.insert("count", double(histogram.Count()));
+        obj.insert("sum", double(histogram.Sum()));
+        obj.insert("buckets", buckets);
+        histograms.insert(it->first, obj);
+    }
+
+    QDateTime now = QDateTime::currentDateTime();
+
+    QJsonObject root;
+    root.insert("time", now.toString(Qt::ISODate));
+    root.insert("uptime_ms", double(registry.started.msecsTo(now)));
+    root.insert("counters", counters);
+    root.insert("gauges", gauges);
+    root.insert("histograms", histograms);
+
+    return QJsonDocument(root).toJson();
+}
+
+void Metrics::SetDirectory(const QString& a_path)
+{
+    s_directory = a_path;
+}
+
+bool Metrics::Dump()
+{
+    if (s_directory.isEmpty() || !QDir().mkpath(s_directory))
+    {
+        logWarn("Could not create the metrics directory: " + s_directory);
+        return false;
+    }
+
+    QString filename = s_directory + "/metrics-"
+            + QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss-zzz") + ".json";
+
+    QFile file(filename);
+
+    if (!file.open(QIODevice::WriteOnly) || file.write(ToJson()) == -1)
+    {
+        logWarn("Could not write the metrics: " + filename);
+        return false;
+    }
+
+    logInfo("Metrics written to " + filename);
+
+    return true;
+}
+
+void Metrics::InstallSignalHandler()
+{
+#ifdef Q_OS_UNIX
+    signal(SIGUSR1, OnSignal);
+#endif
+}
+
+void Metrics::DumpIfRequested()
+{
+    if (s_dumpRequested.load(std::memory_order_relaxed)
+            && s_dumpRequested.exchange(false))
+    {
+        Dump();
+    }
+}
+
+void Metrics::OnSignal(int a_signal)
+{
+    Q_UNUSED(a_signal)
+
+    s_dumpRequested.store(true);
+}
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+#include <atomic>
+#include <memory>
+
+namespace og
+{
+// Process-wide registry of named counters, gauges and histograms. A metric
+// is created on the first lookup and lives until the process exits, so the
+// callers look it up once and keep the pointer:
+//
+//     static Metrics::Counter* s_hits = Metrics::GetCounter("cache.hits");
+//     s_hits->Add();
+//
+// Updating a metric is a relaxed atomic operation and can be done from any
+// thread. The whole registry is written as JSON to the dump directory on
+// SIGUSR1 or on request.
+class Metrics
+{
+public:
+    class Counter
+    {
+    public:
+        Counter() : m_value(0) {}
+
+        void Add(qint64 a_value = 1) { m_value.fetch_add(a_value, std::memory_order_relaxed); }
+        qint64 Value() const { return m_value.load(std::memory_order_relaxed); }
+
+    private:
+        std::atomic<qint64> m_value;
+    };
+
+    class Gauge
+    {
+    public:
+        Gauge() : m_value(0) {}
+
+        void Set(double a_value) { m_value.store(a_value, std::memory_order_relaxed); }
+        double Value() const { return m_value.load(std::memory_order_relaxed); }
+
+    private:
+        std::atomic<double> m_value;
+    };
+
+    // The buckets are given by their inclusive upper bounds in ascending
+    // order, values above the last bound go to an overflow bucket
+    class Histogram
+    {
+    public:
+        explicit Histogram(const QVector<qint64>& a_bounds);
+
+        void Record(qint64 a_value);
+
+        const QVector<qint64>& Bounds() const { return m_bounds; }
+        qint64 BucketCount(int a_bucket) const;
+        qint64 Count() const { return m_count.load(std::memory_order_relaxed); }
+        qint64 Sum() const { return m_sum.load(std::memory_order_relaxed); }
+
+    private:
+        QVector<qint64> m_bounds;
+        std::unique_ptr<std::atomic<qint64>[]> m_buckets;
+        std::atomic<qint64> m_count;
+        std::atomic<qint64> m_sum;
+    };
+
+    static Counter* GetCounter(const QString& a_name);
+    static Gauge* GetGauge(const QString& a_name);
+
+    // The bounds of an existing histogram aren't changed
+    static Histogram* GetHistogram(const QString& a_name, const QVector<qint64>& a_bounds);
+
+    static QByteArray ToJson();
+
+    static void SetDirectory(const QString& a_path);
+
+    // Writes a snapshot into a new file of the dump directory
+    static bool Dump();
+
+    // SIGUSR1 only raises a flag, the dump is written by the next call
+    // of DumpIfRequested() from the game loop
+    static void InstallSignalHandler();
+    static void DumpIfRequested();
+
+private:
+    static QString s_directory;
+    static std::atomic<bool> s_dumpRequested;
+
+    static void OnSignal(int a_signal);
+};
+}
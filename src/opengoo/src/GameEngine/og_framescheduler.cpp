@@ -0,0 +1,184 @@
+#include "og_framescheduler.h"
+#include "logger.h"
+#include "metrics.h"
+
+#include <algorithm>
+
+using namespace og;
+
+namespace
+{
+const qint64 REPORT_TIME = 1000; // in milliseconds
+
+inline float percentile(const QVector<float>& a_sorted, float a_p)
+{
+    return a_sorted.at(int(a_p * (a_sorted.size() - 1)));
+}
+}
+
+OGFrameScheduler::OGFrameScheduler(Mode a_mode, int a_framerate)
+    : m_mode(a_mode)
+    , m_deadline(0)
+    , m_lastPresent(0)
+    , m_lastReport(0)
+    , m_active(false)
+    , m_samples(SAMPLES)
+    , m_sampleCount(0)
+    , m_inputSamples(SAMPLES)
+    , m_inputSampleCount(0)
+    , m_inputTime(0)
+{
+    m_period = 1000.0 / qMax(a_framerate, 1);
+
+    m_timer.setSingleShot(true);
+    m_timer.setTimerType(Qt::PreciseTimer);
+
+    connect(&m_timer, SIGNAL(timeout()), this, SLOT(tick()));
+}
+
+OGFrameScheduler::Mode OGFrameScheduler::modeFromString(const QString& a_mode)
+{
+    if (a_mode == "fixed") return FIXED;
+    else if (a_mode == "uncapped") return UNCAPPED;
+    else if (!a_mode.isEmpty() && a_mode != "vsync")
+        logWarn("Unknown frame pacing: " + a_mode);
+
+    return VSYNC;
+}
+
+void OGFrameScheduler::start()
+{
+    if (m_active) return;
+
+    m_active = true;
+    m_clock.start();
+    m_deadline = 0;
+    m_lastPresent = 0;
+    m_lastReport = 0;
+    m_inputTime = 0;
+    m_timer.start(0);
+}
+
+void OGFrameScheduler::stop()
+{
+    if (!m_active) return;
+
+    m_active = false;
+    m_timer.stop();
+
+    updateTimes();
+    logInfof("Frame time p50: %1 ms, p95: %2 ms, p99: %3 ms"
+             , m_times.p50, m_times.p95, m_times.p99);
+    logInfof("Input latency p50: %1 ms, p95: %2 ms, p99: %3 ms"
+             , m_times.inputP50, m_times.inputP95, m_times.inputP99);
+}
+
+void OGFrameScheduler::framePresented()
+{
+    if (!m_active) return;
+
+    qint64 time = m_clock.nsecsElapsed();
+
+    if (m_lastPresent != 0)
+    {
+        m_samples[m_sampleCount % SAMPLES] = (time - m_lastPresent) / 1e6f;
+        m_sampleCount++;
+    }
+
+    m_lastPresent = time;
+
+    if (m_inputTime != 0)
+    {
+        static Metrics::Histogram* latency = Metrics::GetHistogram("input.latency_us"
+                , QVector<qint64>() << 4000 << 8000 << 16000 << 33000 << 66000 << 133000);
+
+        qint64 delay = timestamp() - m_inputTime;
+        m_inputSamples[m_inputSampleCount % SAMPLES] = delay / 1e6f;
+        m_inputSampleCount++;
+        m_inputTime = 0;
+
+        latency->Record(delay / 1000);
+    }
+
+    if (m_clock.elapsed() - m_lastReport >= REPORT_TIME)
+    {
+        m_lastReport = m_clock.elapsed();
+        updateTimes();
+    }
+
+    schedule();
+}
+
+void OGFrameScheduler::inputConsumed(qint64 a_time)
+{
+    if (a_time == 0) return;
+
+    if (m_inputTime == 0 || a_time < m_inputTime) m_inputTime = a_time;
+}
+
+qint64 OGFrameScheduler::timestamp()
+{
+    static QElapsedTimer s_clock = []()
+    {
+        QElapsedTimer clock;
+        clock.start();
+        return clock;
+    }();
+
+    // 0 means "no input", so the first stamp isn't allowed to be 0
+    return s_clock.nsecsElapsed() + 1;
+}
+
+void OGFrameScheduler::tick()
+{
+    if (m_active) emit frame();
+}
+
+inline double OGFrameScheduler::now() const
+{
+    return m_clock.nsecsElapsed() / 1e6;
+}
+
+void OGFrameScheduler::schedule()
+{
+    if (m_mode != FIXED)
+    {
+        // The swap of the previous frame has already waited for vsync
+        m_timer.start(0);
+        return;
+    }
+
+    double time = now();
+    m_deadline += m_period;
+
+    // After a long frame the missed deadlines are skipped instead of
+    // being rendered back to back
+    if (m_deadline < time - m_period) m_deadline = time;
+
+    m_timer.start(qMax(0, qRound(m_deadline - time)));
+}
+
+void OGFrameScheduler::updateTimes()
+{
+    percentiles(m_samples, m_sampleCount
+                , &m_times.p50, &m_times.p95, &m_times.p99);
+    percentiles(m_inputSamples, m_inputSampleCount
+                , &m_times.inputP50, &m_times.inputP95, &m_times.inputP99);
+}
+
+bool OGFrameScheduler::percentiles(const QVector<float>& a_samples, int a_count
+                                   , float* a_p50, float* a_p95, float* a_p99)
+{
+    int n = qMin(a_count, int(SAMPLES));
+
+    if (n == 0) return false;
+
+    QVector<float> sorted = a_samples.mid(0, n);
+    std::sort(sorted.begin(), sorted.end());
+
+    *a_p50 = percentile(sorted, 0.50f);
+    *a_p95 = percentile(sorted, 0.95f);
+    *a_p99 = percentile(sorted, 0.99f);
+
+    return true;
+}
@@ -0,0 +1,109 @@
+#ifndef OG_FRAMESCHEDULER_H
+#define OG_FRAMESCHEDULER_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+
+class QString;
+
+namespace og
+{
+    struct OGFrameTimes
+    {
+        float p50;
+        float p95;
+        float p99;
+
+        // From the oldest input shown by a frame to its presentation
+        float inputP50;
+        float inputP95;
+        float inputP99;
+
+        OGFrameTimes()
+            : p50(0), p95(0), p99(0), inputP50(0), inputP95(0), inputP99(0)
+        {
+        }
+    };
+
+    // Drives the frame loop of the window.
+    //  VSYNC    - the next frame starts as soon as the previous one has been
+    //             presented, the buffer swap waits for the vertical blank.
+    //  FIXED    - frames start on absolute deadlines of 1/framerate seconds,
+    //             so the rounding to milliseconds doesn't accumulate.
+    //  UNCAPPED - as fast as possible, for benchmarking.
+    // It also keeps the recent frame times, the input-to-present latencies
+    // and their percentiles.
+    class OGFrameScheduler : public QObject
+    {
+            Q_OBJECT
+
+        public:
+            enum Mode
+            {
+                VSYNC
+                , FIXED
+                , UNCAPPED
+            };
+
+            OGFrameScheduler(Mode a_mode, int a_framerate);
+
+            static Mode modeFromString(const QString& a_mode);
+
+            Mode mode() const { return m_mode; }
+
+            void start();
+            void stop();
+
+            // Must be called when the frame has been presented
+            void framePresented();
+
+            // The frame being built shows the result of the input stamped
+            // with a_time, the latency is taken when it's presented
+            void inputConsumed(qint64 a_time);
+
+            // Monotonic process-wide clock in nanoseconds, thread-safe.
+            // Input events are stamped with it.
+            static qint64 timestamp();
+
+            // Updated once a second, in milliseconds
+            const OGFrameTimes& frameTimes() const { return m_times; }
+
+        signals:
+            void frame();
+
+        private slots:
+            void tick();
+
+        private:
+            enum { SAMPLES = 512 };
+
+            Mode m_mode;
+            double m_period;
+            double m_deadline;
+            qint64 m_lastPresent;
+            qint64 m_lastReport;
+            bool m_active;
+
+            QTimer m_timer;
+            QElapsedTimer m_clock;
+
+            QVector<float> m_samples;
+            int m_sampleCount;
+            QVector<float> m_inputSamples;
+            int m_inputSampleCount;
+            qint64 m_inputTime;
+            OGFrameTimes m_times;
+
+            double now() const;
+            void schedule();
+            void updateTimes();
+
+            static bool percentiles(const QVector<float>& a_samples, int a_count
+                                    , float* a_p50, float* a_p95, float* a_p99);
+    };
+
+} // namespace og
+
+#endif // OG_FRAMESCHEDULER_H
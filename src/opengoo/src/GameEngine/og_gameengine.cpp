@@ -21,7 +21,10 @@ OGGameEngine::OGGameEngine(OGGame* a_game, const OGConfig& a_config, bool a_crt)
     m_width = a_config.screen_width;
     m_height = a_config.screen_height;
     m_fullscreen = a_config.fullscreen;
-    m_frameDelay = 1000.0f / a_config.refreshrate;
+    m_frameRate = a_config.refreshrate;
+    m_frameDelay = qRound(1000.0f / a_config.refreshrate);
+    m_framePacing = OGFrameScheduler::modeFromString(a_config.framepacing);
+    m_maxFrameSteps = qMax(a_config.maxframesteps, 1);
     m_crt = a_crt;
     m_isVideoModeSupported = false;
     m_resourceManager = nullptr;
@@ -39,7 +42,9 @@ bool OGGameEngine::initialize()
 {
     qApp->installEventFilter(this);
 
-    m_window.reset(new OGWindow(m_game));
+    QGLFormat format;
+    format.setSwapInterval(m_framePacing == OGFrameScheduler::VSYNC ? 1 : 0);
+    m_window.reset(new OGWindow(m_game, format));
 
     QScreen* screen = getPrimaryScreen();
     int x = (screen->geometry().width() - getWidth()) / 2.0f;
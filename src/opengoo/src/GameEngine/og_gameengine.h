@@ -4,6 +4,7 @@
 #include <memory>
 
 #include "og_widget.h"
+#include "og_framescheduler.h"
 
 typedef og::OGWidget OGWindow;
 
@@ -33,6 +34,9 @@ namespace og
             static OGGameEngine* m_instance;
             int m_width, m_height;
             int m_frameDelay;
+            int m_frameRate;
+            OGFrameScheduler::Mode m_framePacing;
+            int m_maxFrameSteps;
             bool m_fullscreen;
             bool m_crt;
             OGGame* m_game;
@@ -50,6 +54,12 @@ namespace og
             int getWidth() const { return m_width; }
             int getHeight() const { return m_height; }
             int getFrameDelay() const { return m_frameDelay; }
+            int getFrameRate() const { return m_frameRate; }
+            OGFrameScheduler::Mode getFramePacing() const { return m_framePacing; }
+
+            // How many simulation steps may be taken to catch up
+            // after a long frame
+            int getMaxFrameSteps() const { return m_maxFrameSteps; }
 
             OGPhysicsEngine* getPhysicsEngine();
 
@@ -66,7 +76,11 @@ namespace og
             }
 
         public slots:
-            void setFrameRate(int a_framerate) { m_frameDelay = qRound(1000.0f / a_framerate); }
+            void setFrameRate(int a_framerate)
+            {
+                m_frameRate = a_framerate;
+                m_frameDelay = qRound(1000.0f / a_framerate);
+            }
             void quit();
 
         private slots:
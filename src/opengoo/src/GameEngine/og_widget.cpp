@@ -5,7 +5,9 @@
 
 using namespace og;
 
-OGWidget::OGWidget(OGGame* game)
+OGWidget::OGWidget(OGGame* game, const QGLFormat& format)
+    : QGLWidget(format)
+    , _scheduler(GE->getFramePacing(), GE->getFrameRate())
 {
     _pGame = game;
 
@@ -14,15 +16,15 @@ OGWidget::OGWidget(OGGame* game)
     setMouseTracking(true);
     setAutoFillBackground(false);
 
-    connect(&_timer, SIGNAL(timeout()), this, SLOT(Update()));
+    connect(&_scheduler, SIGNAL(frame()), this, SLOT(Update()));
 }
 
 void OGWidget::setActive(bool active)
 {
     if (active)
-        _timer.start(GE->getFrameDelay());
+        _scheduler.start();
     else
-        _timer.stop();
+        _scheduler.stop();
 }
 
 ui::UIList& OGWidget::uiList() { return _uiList; }
@@ -57,7 +59,10 @@ void OGWidget::Update()
 {
     getGame()->Cycle();
 
+    // The buffers are swapped when the painting is finished
     repaint();
+
+    _scheduler.framePresented();
 }
 
 void OGWidget::keyReleaseEvent(QKeyEvent* ev)
@@ -75,7 +80,7 @@ void OGWidget::showEvent(QShowEvent* ev)
     Q_UNUSED(ev)
 
     getGame()->Start();
-    _timer.start(GE->getFrameDelay());
+    _scheduler.start();
 }
 
 void OGWidget::resizeEvent(QResizeEvent* ev)
@@ -3,9 +3,9 @@
 
 #include <QGLWidget>
 #include "og_iui.h"
+#include "og_framescheduler.h"
 
 #include <QHash>
-#include <QTimer>
 
 class QString;
 
@@ -18,10 +18,13 @@ namespace og
             Q_OBJECT
 
         public:
-            explicit OGWidget(OGGame* game);
+            OGWidget(OGGame* game, const QGLFormat& format);
 
             void setActive(bool active);
 
+            OGFrameScheduler& frameScheduler() { return _scheduler; }
+            const OGFrameScheduler& frameScheduler() const { return _scheduler; }
+
             void addUI(ui::IUI* ui);
             void removeUI(ui::IUI* ui);
 
@@ -53,7 +56,7 @@ namespace og
 
         private:
             OGGame* _pGame;
-            QTimer _timer;
+            OGFrameScheduler _scheduler;
             ui::UIList _uiList;
     };
 
@@ -0,0 +1,320 @@
+#include "textrenderer.h"
+#include "metrics.h"
+
+#include <logger.h>
+
+#include <QFile>
+#include <QFontDatabase>
+#include <QGlyphRun>
+#include <QTextLayout>
+
+using namespace og;
+
+namespace
+{
+const int PAGE_SIZE = 512; // in pixels
+const int MAX_PAGES = 8;   // 8 MB of the ARGB32 pages
+const int MAX_RUNS = 1024;
+const int PADDING = 1;     // around a glyph, for the antialiasing
+
+inline QString FaceKey(const QRawFont& a_font, const QColor& a_color)
+{
+    return QString("%1/%2/%3/%4").arg(a_font.familyName(), a_font.styleName())
+           .arg(a_font.pixelSize()).arg(a_color.rgba());
+}
+}
+
+TextRenderer::TextRenderer()
+    : m_x(0)
+    , m_y(0)
+    , m_shelf(0)
+{
+}
+
+TextRenderer& TextRenderer::Instance()
+{
+    static TextRenderer instance;
+
+    return instance;
+}
+
+void TextRenderer::Draw(QPainter* a_painter, const QRectF& a_rect, int a_flags
+                        , const QString& a_text, const QFont& a_font
+                        , const QColor& a_color)
+{
+    if (a_text.isEmpty()) return;
+
+    TextRenderer& self = Instance();
+    const Run& run = self.GetRun(a_text, a_font, a_color);
+
+    QPointF origin = a_rect.topLeft();
+
+    if (a_flags & Qt::AlignHCenter)
+        origin.rx() += (a_rect.width() - run.size.width()) / 2;
+    else if (a_flags & Qt::AlignRight)
+        origin.rx() += a_rect.width() - run.size.width();
+
+    if (a_flags & Qt::AlignVCenter)
+        origin.ry() += (a_rect.height() - run.size.height()) / 2;
+    else if (a_flags & Qt::AlignBottom)
+        origin.ry() += a_rect.height() - run.size.height();
+
+    for (int page = 0; page < self.m_pages.size(); page++)
+    {
+        self.m_fragments.clear();
+
+        Q_FOREACH(const Fragment& f, run.fragments)
+        {
+            if (f.page != page) continue;
+
+            QPainter::PixmapFragment fragment = f.fragment;
+            fragment.x += origin.x();
+            fragment.y += origin.y();
+
+            // Each line is aligned in the block
+            if (a_flags & Qt::AlignHCenter)
+                fragment.x += f.slack / 2;
+            else if (a_flags & Qt::AlignRight)
+                fragment.x += f.slack;
+            self.m_fragments << fragment;
+        }
+
+        if (self.m_fragments.isEmpty()) continue;
+
+        Page& p = self.m_pages[page];
+
+        if (p.isDirty)
+        {
+            p.pixmap = QPixmap::fromImage(p.image);
+            p.isDirty = false;
+        }
+
+        a_painter->drawPixmapFragments(self.m_fragments.constData()
+                                       , self.m_fragments.size(), p.pixmap);
+    }
+}
+
+QString TextRenderer::AddFont(const QString& a_filename)
+{
+    QHash<QString, QString>& families = Instance().m_families;
+    QHash<QString, QString>::const_iterator it = families.constFind(a_filename);
+
+    if (it != families.constEnd()) return it.value();
+
+    QString family;
+
+    if (QFile::exists(a_filename))
+    {
+        int id = QFontDatabase::addApplicationFont(a_filename);
+        QStringList list = QFontDatabase::applicationFontFamilies(id);
+
+        if (!list.isEmpty()) family = list.first();
+        else logWarn("Font " + a_filename + " can't be loaded");
+    }
+
+    families.insert(a_filename, family);
+
+    return family;
+}
+
+const TextRenderer::Run& TextRenderer::GetRun(const QString& a_text
+                                              , const QFont& a_font
+                                              , const QColor& a_color)
+{
+    RunKey key(a_font.key() + '/' + QString::number(a_color.rgba()), a_text);
+    QHash<RunKey, Run>::const_iterator it = m_runs.constFind(key);
+
+    if (it != m_runs.constEnd()) return it.value();
+
+    if (m_runs.size() >= MAX_RUNS) m_runs.clear();
+
+    Run run;
+
+    // The atlas is full, the glyphs of this run get it to themselves
+    if (!Shape(a_text, a_font, a_color, &run))
+    {
+        Reset();
+        run = Run();
+        Shape(a_text, a_font, a_color, &run);
+    }
+
+    return m_runs.insert(key, run).value();
+}
+
+bool TextRenderer::Shape(const QString& a_text, const QFont& a_font
+                         , const QColor& a_color, Run* a_run)
+{
+    QString text = a_text;
+    text.replace('\n', QChar::LineSeparator);
+
+    QTextLayout layout(text, a_font);
+    qreal y = 0;
+    qreal width = 0;
+
+    layout.beginLayout();
+
+    for (QTextLine line = layout.createLine(); line.isValid()
+            ; line = layout.createLine())
+    {
+        line.setPosition(QPointF(0, y));
+        y += line.height();
+        width = qMax(width, line.naturalTextWidth());
+    }
+
+    layout.endLayout();
+
+    a_run->size = QSizeF(width, y);
+
+    bool isComplete = true;
+
+    for (int l = 0; l < layout.lineCount(); l++)
+    {
+        QTextLine line = layout.lineAt(l);
+        qreal slack = width - line.naturalTextWidth();
+
+        Q_FOREACH(const QGlyphRun& glyphs, line.glyphRuns())
+        {
+            QRawFont font = glyphs.rawFont();
+            QVector<quint32> indexes = glyphs.glyphIndexes();
+            QVector<QPointF> positions = glyphs.positions();
+
+            for (int i = 0; i < indexes.size(); i++)
+            {
+                Glyph glyph;
+
+                if (!GetGlyph(font, a_color, indexes.at(i), &glyph))
+                {
+                    isComplete = false;
+                    continue;
+                }
+
+                if (glyph.page < 0) continue;
+
+                // A fragment is placed by its center
+                QPointF pos = positions.at(i) + glyph.offset
+                              + QPointF(glyph.source.width() / 2
+                                        , glyph.source.height() / 2);
+
+                Fragment f;
+                f.page = glyph.page;
+                f.fragment = QPainter::PixmapFragment::create(pos
+                                                              , glyph.source);
+                f.slack = slack;
+                a_run->fragments << f;
+            }
+        }
+    }
+
+    return isComplete;
+}
+
+bool TextRenderer::GetGlyph(const QRawFont& a_font, const QColor& a_color
+                            , quint32 a_index, Glyph* a_glyph)
+{
+    QString face = FaceKey(a_font, a_color);
+    QHash<QString, int>::const_iterator it = m_faces.constFind(face);
+
+    if (it == m_faces.constEnd())
+        it = m_faces.insert(face, m_faces.size());
+
+    GlyphKey key(it.value(), a_index);
+    QHash<GlyphKey, Glyph>::const_iterator glyph = m_glyphs.constFind(key);
+
+    if (glyph != m_glyphs.constEnd())
+    {
+        *a_glyph = glyph.value();
+        return true;
+    }
+
+    QRect cell = a_font.boundingRect(a_index).toAlignedRect()
+                 .adjusted(-PADDING, -PADDING, PADDING, PADDING);
+
+    // A space has nothing to paint, a huge glyph is skipped
+    if (cell.width() <= 2 * PADDING || cell.height() <= 2 * PADDING
+            || cell.width() > PAGE_SIZE || cell.height() > PAGE_SIZE)
+    {
+        a_glyph->page = -1;
+        m_glyphs.insert(key, *a_glyph);
+
+        return true;
+    }
+
+    int page;
+    QPoint pos;
+
+    if (!Allocate(cell.size(), &page, &pos)) return false;
+
+    QGlyphRun run;
+    run.setRawFont(a_font);
+    run.setGlyphIndexes(QVector<quint32>() << a_index);
+    run.setPositions(QVector<QPointF>() << QPointF(0, 0));
+
+    QPainter painter(&m_pages[page].image);
+    painter.setRenderHint(QPainter::TextAntialiasing);
+    painter.setClipRect(QRect(pos, cell.size()));
+    painter.setPen(a_color);
+    painter.drawGlyphRun(pos - cell.topLeft(), run);
+
+    m_pages[page].isDirty = true;
+
+    a_glyph->page = page;
+    a_glyph->source = QRectF(pos, cell.size());
+    a_glyph->offset = cell.topLeft();
+    m_glyphs.insert(key, *a_glyph);
+
+    return true;
+}
+
+// Glyphs are put on shelves, left to right and top to bottom
+bool TextRenderer::Allocate(const QSize& a_size, int* a_page, QPoint* a_pos)
+{
+    static Metrics::Gauge* pages = Metrics::GetGauge("text.atlas_pages");
+
+    if (!m_pages.isEmpty() && m_x + a_size.width() > PAGE_SIZE)
+    {
+        m_x = 0;
+        m_y += m_shelf;
+        m_shelf = 0;
+    }
+
+    if (m_pages.isEmpty() || m_y + a_size.height() > PAGE_SIZE)
+    {
+        if (m_pages.size() >= MAX_PAGES) return false;
+
+        Page page;
+        page.image = QImage(PAGE_SIZE, PAGE_SIZE
+                            , QImage::Format_ARGB32_Premultiplied);
+        page.image.fill(Qt::transparent);
+        page.isDirty = true;
+        m_pages << page;
+
+        m_x = 0;
+        m_y = 0;
+        m_shelf = 0;
+
+        pages->Set(m_pages.size());
+    }
+
+    *a_page = m_pages.size() - 1;
+    *a_pos = QPoint(m_x, m_y);
+
+    m_x += a_size.width();
+    m_shelf = qMax(m_shelf, a_size.height());
+
+    return true;
+}
+
+void TextRenderer::Reset()
+{
+    static Metrics::Gauge* pages = Metrics::GetGauge("text.atlas_pages");
+
+    m_faces.clear();
+    m_glyphs.clear();
+    m_runs.clear();
+    m_pages.clear();
+    m_x = 0;
+    m_y = 0;
+    m_shelf = 0;
+
+    pages->Set(0);
+}
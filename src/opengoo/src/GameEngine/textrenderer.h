@@ -0,0 +1,91 @@
+#pragma once
+
+#include <QColor>
+#include <QFont>
+#include <QHash>
+#include <QImage>
+#include <QPainter>
+#include <QPair>
+#include <QPixmap>
+#include <QRawFont>
+#include <QRectF>
+#include <QString>
+#include <QVector>
+
+namespace og
+{
+// Draws text from a glyph atlas, on the GUI thread. A glyph is rasterised
+// once per font and colour into a page of the atlas. A string is shaped
+// once into a run of glyphs which is kept by the font, colour and text, so
+// drawing it again is one drawPixmapFragments() call per page.
+//
+// The atlas and the runs are dropped when the atlas is full, the next
+// strings rasterise their glyphs again.
+class TextRenderer
+{
+public:
+    // a_flags is a combination of Qt::Alignment, like for drawText()
+    static void Draw(QPainter* a_painter, const QRectF& a_rect, int a_flags
+                     , const QString& a_text, const QFont& a_font
+                     , const QColor& a_color);
+
+    // Loads a font file once and returns its family, or an empty string
+    static QString AddFont(const QString& a_filename);
+
+private:
+    struct Glyph
+    {
+        int page;
+        QRectF source;
+        QPointF offset; // of the source from the pen position
+    };
+
+    struct Fragment
+    {
+        int page;
+        QPainter::PixmapFragment fragment; // from the top left of the run
+        qreal slack; // the block width less the width of the line
+    };
+
+    struct Run
+    {
+        QVector<Fragment> fragments;
+        QSizeF size;
+    };
+
+    struct Page
+    {
+        QImage image;
+        QPixmap pixmap;
+        bool isDirty;
+    };
+
+    typedef QPair<int, quint32> GlyphKey; // face, glyph index
+    typedef QPair<QString, QString> RunKey; // font and colour, text
+
+    QHash<QString, int> m_faces;
+    QHash<GlyphKey, Glyph> m_glyphs;
+    QHash<RunKey, Run> m_runs;
+    QHash<QString, QString> m_families;
+    QVector<Page> m_pages;
+    QVector<QPainter::PixmapFragment> m_fragments;
+
+    // The shelf being filled in the last page
+    int m_x;
+    int m_y;
+    int m_shelf;
+
+    TextRenderer();
+
+    static TextRenderer& Instance();
+
+    const Run& GetRun(const QString& a_text, const QFont& a_font
+                      , const QColor& a_color);
+    bool Shape(const QString& a_text, const QFont& a_font
+               , const QColor& a_color, Run* a_run);
+    bool GetGlyph(const QRawFont& a_font, const QColor& a_color
+                  , quint32 a_index, Glyph* a_glyph);
+    bool Allocate(const QSize& a_size, int* a_page, QPoint* a_pos);
+    void Reset();
+};
+}
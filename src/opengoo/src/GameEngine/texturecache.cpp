@@ -0,0 +1,212 @@
+#include "texturecache.h"
+#include "metrics.h"
+#include "logger.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+namespace
+{
+const quint32 MAGIC = 0x4354474F; // "OGTC"
+const quint32 VERSION = 1;
+
+struct Header
+{
+    quint32 magic;
+    quint32 version;
+    qint32 width;
+    qint32 height;
+    qint32 bytesPerLine;
+    qint32 reserved;
+};
+
+void UnmapEntry(void* a_file)
+{
+    delete static_cast<QFile*>(a_file);
+}
+}
+
+namespace og
+{
+QString TextureCache::s_directory;
+QHash<QString, QPixmap> TextureCache::s_pixmaps;
+
+void TextureCache::SetDirectory(const QString& a_path)
+{
+    if (!QDir().mkpath(a_path))
+    {
+        logWarn("Could not create the texture cache: " + a_path);
+        return;
+    }
+
+    s_directory = a_path;
+}
+
+QImage TextureCache::Load(const QString& a_filename)
+{
+    if (s_directory.isEmpty())
+        return QImage(a_filename);
+
+    QString entry = GetEntryName(a_filename);
+
+    if (entry.isEmpty())
+        return QImage();
+
+    static Metrics::Counter* s_hits = Metrics::GetCounter("texturecache.hits");
+    static Metrics::Counter* s_misses = Metrics::GetCounter("texturecache.misses");
+    static Metrics::Counter* s_bytes = Metrics::GetCounter("texturecache.decoded_bytes");
+
+    QImage image = Map(entry);
+
+    if (!image.isNull())
+    {
+        s_hits->Add();
+        return image;
+    }
+
+    s_misses->Add();
+    RemoveStale(entry);
+
+    if (!image.load(a_filename))
+        return image;
+
+    image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    s_bytes->Add(image.byteCount());
+    Store(entry, image);
+
+    return image;
+}
+
+QPixmap TextureCache::LoadPixmap(const QString& a_filename)
+{
+    QHash<QString, QPixmap>::const_iterator it = s_pixmaps.constFind(a_filename);
+
+    if (it != s_pixmaps.constEnd())
+        return it.value();
+
+    QPixmap pixmap = QPixmap::fromImage(Load(a_filename));
+
+    if (pixmap.isNull())
+        logWarn("Image " + a_filename + " not found");
+
+    s_pixmaps.insert(a_filename, pixmap);
+
+    return pixmap;
+}
+
+QString TextureCache::GetEntryName(const QString& a_filename)
+{
+    QFileInfo info(a_filename);
+
+    if (!info.exists())
+        return QString();
+
+    QByteArray path = info.absoluteFilePath().toUtf8();
+    QByteArray hash = QCryptographicHash::hash(path, QCryptographicHash::Sha1);
+
+    QString name = hash.toHex() + "-"
+            + QString::number(info.lastModified().toMSecsSinceEpoch(), 16) + "-"
+            + QString::number(info.size(), 16);
+
+    return s_directory + "/" + name + ".tex";
+}
+
+// Removes the entries of the other versions of the entry's file, they
+// share the part of the name before the first '-'
+void TextureCache::RemoveStale(const QString& a_entry)
+{
+    QFileInfo info(a_entry);
+    QString prefix = info.fileName().section('-', 0, 0) + "-";
+    QDir dir(s_directory);
+
+    Q_FOREACH (const QString& name, dir.entryList(QStringList(prefix + "*.tex")
+                                                  , QDir::Files))
+    {
+        if (name != info.fileName())
+            dir.remove(name);
+    }
+}
+
+// The returned image refers to the mapped file, which is unmapped
+// when the last copy of the image is destroyed
+QImage TextureCache::Map(const QString& a_entry)
+{
+    QFile* file = new QFile(a_entry);
+
+    if (!file->open(QIODevice::ReadOnly) || file->size() < qint64(sizeof(Header)))
+    {
+        delete file;
+        return QImage();
+    }
+
+    uchar* data = file->map(0, file->size());
+
+    if (!data)
+    {
+        delete file;
+        return QImage();
+    }
+
+    const Header* header = reinterpret_cast<const Header*>(data);
+    qint64 size = qint64(header->bytesPerLine) * header->height;
+
+    if (header->magic != MAGIC || header->version != VERSION
+            || header->width <= 0 || header->height <= 0
+            || file->size() != qint64(sizeof(Header)) + size)
+    {
+        logWarn("Corrupted texture cache entry: " + a_entry);
+        delete file;
+        QFile::remove(a_entry);
+        return QImage();
+    }
+
+    const uchar* pixels = data + sizeof(Header);
+
+    // The const constructor makes the image read-only, it detaches
+    // instead of writing to the mapping
+    return QImage(pixels, header->width, header->height,
+                  header->bytesPerLine, QImage::Format_ARGB32_Premultiplied,
+                  UnmapEntry, file);
+}
+
+void TextureCache::Store(const QString& a_entry, const QImage& a_image)
+{
+    Header header;
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.width = a_image.width();
+    header.height = a_image.height();
+    header.bytesPerLine = a_image.bytesPerLine();
+    header.reserved = 0;
+
+    // Written under a temporary name, so a crash can't leave
+    // a truncated entry
+    QString tmp = a_entry + ".tmp";
+    QFile file(tmp);
+
+    if (!file.open(QIODevice::WriteOnly))
+        return;
+
+    qint64 size = qint64(a_image.bytesPerLine()) * a_image.height();
+    bool ok = file.write(reinterpret_cast<const char*>(&header), sizeof(header))
+              == qint64(sizeof(header))
+              && file.write(reinterpret_cast<const char*>(a_image.constBits()), size)
+              == size;
+    file.close();
+
+    if (ok)
+    {
+        QFile::remove(a_entry);
+        ok = QFile::rename(tmp, a_entry);
+    }
+
+    if (!ok)
+    {
+        logWarn("Could not write the texture cache entry: " + a_entry);
+        QFile::remove(tmp);
+    }
+}
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <QHash>
+#include <QImage>
+#include <QPixmap>
+#include <QString>
+
+namespace og
+{
+// Persistent cache of decoded images. The first load of an image decodes
+// the file and stores its premultiplied ARGB32 pixels in the cache
+// directory; later loads map the stored blob into memory, no decoding
+// is done. An entry is named after the path of the source file and its
+// modification time and size. A changed file gets a new entry, which
+// replaces the entries of the file's older versions.
+class TextureCache
+{
+public:
+    // The cache is disabled until the directory is set
+    static void SetDirectory(const QString& a_path);
+
+    static QImage Load(const QString& a_filename);
+
+    // The images of the menus, which are created again each time they are
+    // opened. A pixmap is decoded once and kept for the session, the
+    // copies share its pixels. GUI thread only.
+    static QPixmap LoadPixmap(const QString& a_filename);
+
+private:
+    static QString s_directory;
+    static QHash<QString, QPixmap> s_pixmaps;
+
+    static QString GetEntryName(const QString& a_filename);
+    static void RemoveStale(const QString& a_entry);
+    static QImage Map(const QString& a_entry);
+    static void Store(const QString& a_entry, const QImage& a_image);
+};
+}
@@ -1,5 +1,7 @@
 #include "og_uilabel.h"
 
+#include "textrenderer.h"
+
 #include <QPainter>
 
 using namespace og::ui;
@@ -25,13 +27,8 @@ void Label::_Paint(QPainter* painter)
 {
     Frame::_Paint(painter);
 
-    painter->save();
-
-    painter->setPen(_pImpl->fontColor);
-    painter->setFont(_pImpl->font);
-    painter->drawText(rect(), Qt::AlignLeft, _pImpl->text);
-
-    painter->restore();
+    TextRenderer::Draw(painter, rect(), Qt::AlignLeft, _pImpl->text
+                       , _pImpl->font, _pImpl->fontColor);
 }
 
 void Label::setFont(const QFont &font)
@@ -1,5 +1,7 @@
 #include "og_uipushbutton.h"
 
+#include "textrenderer.h"
+
 #include <QMouseEvent>
 #include <QPainter>
 
@@ -76,12 +78,10 @@ void PushButton::_Paint(QPainter *painter)
         painter->drawPixmap(rect(), *_pImpl->pUp, _pImpl->pUp->rect());
     }
 
-    painter->setPen(_pImpl->fontColor);
-    painter->setFont(_pImpl->font);
-
-    painter->drawText(rect(), Qt::AlignCenter, _pImpl->text);
-
     painter->restore();
+
+    TextRenderer::Draw(painter, rect(), Qt::AlignCenter, _pImpl->text
+                       , _pImpl->font, _pImpl->fontColor);
 }
 
 void PushButton::_onMouseDown(QMouseEvent* ev)
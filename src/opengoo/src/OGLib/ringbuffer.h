@@ -0,0 +1,63 @@
+#ifndef RINGBUFFER_H
+#define RINGBUFFER_H
+
+#include <atomic>
+#include <cstddef>
+
+namespace oglib
+{
+// Bounded single-producer/single-consumer queue. Push() and Pop() never
+// block and never allocate; Push() fails when the queue is full.
+// Size must be a power of two.
+template<class T, std::size_t Size>
+class RingBuffer
+{
+        static_assert((Size & (Size - 1)) == 0, "Size must be a power of two");
+
+        T buffer_[Size];
+        std::atomic<std::size_t> head_;
+        std::atomic<std::size_t> tail_;
+
+        RingBuffer(const RingBuffer&);
+        RingBuffer& operator=(const RingBuffer&);
+
+    public:
+        RingBuffer() : head_(0), tail_(0) {}
+
+        bool Push(const T &value)
+        {
+            std::size_t tail = tail_.load(std::memory_order_relaxed);
+
+            if (tail - head_.load(std::memory_order_acquire) == Size)
+                return false;
+
+            buffer_[tail & (Size - 1)] = value;
+            tail_.store(tail + 1, std::memory_order_release);
+
+            return true;
+        }
+
+        bool Pop(T* value)
+        {
+            std::size_t head = head_.load(std::memory_order_relaxed);
+
+            if (head == tail_.load(std::memory_order_acquire))
+                return false;
+
+            *value = buffer_[head & (Size - 1)];
+            head_.store(head + 1, std::memory_order_release);
+
+            return true;
+        }
+
+        bool IsEmpty() const
+        {
+            return head_.load(std::memory_order_acquire)
+                    == tail_.load(std::memory_order_acquire);
+        }
+
+        std::size_t Capacity() const { return Size; }
+};
+}
+
+#endif // RINGBUFFER_H
@@ -0,0 +1,61 @@
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <atomic>
+
+namespace oglib
+{
+// Lock-free handoff of a value from one writer thread to one reader thread.
+// The writer fills Back() and calls Publish(); the reader calls Front() and
+// always gets the latest complete value. Neither side ever waits and
+// the slots are reused, so their allocations survive between frames.
+template<class T>
+class TripleBuffer
+{
+        enum { INDEX_MASK = 3, FRESH = 4 };
+
+        T slots_[3];
+        int back_;
+        int front_;
+        std::atomic<int> middle_; // index of the shared slot | FRESH
+
+        TripleBuffer(const TripleBuffer&);
+        TripleBuffer& operator=(const TripleBuffer&);
+
+    public:
+        TripleBuffer() : back_(0), front_(1), middle_(2) {}
+
+        // Writer side
+        T& Back() { return slots_[back_]; }
+
+        // Returns true if the previous value was never read. It's handed
+        // back as Back(), so the writer can carry something over from it.
+        bool Publish()
+        {
+            int middle = middle_.exchange(back_ | FRESH
+                                          , std::memory_order_acq_rel);
+            back_ = middle & INDEX_MASK;
+
+            return (middle & FRESH) != 0;
+        }
+
+        // Reader side. The reference stays valid until the next call,
+        // fresh is set if the value hasn't been returned before.
+        const T& Front(bool* fresh = 0)
+        {
+            bool isFresh = middle_.load(std::memory_order_relaxed) & FRESH;
+
+            if (isFresh)
+            {
+                front_ = middle_.exchange(front_, std::memory_order_acq_rel)
+                         & INDEX_MASK;
+            }
+
+            if (fresh) *fresh = isFresh;
+
+            return slots_[front_];
+        }
+};
+}
+
+#endif // TRIPLEBUFFER_H
@@ -7,6 +7,9 @@ void OGContactListener::BeginContact(b2Contact* contact)
     b2Fixture* fixtureA = contact->GetFixtureA();
     b2Fixture* fixtureB = contact->GetFixtureB();   
 
+    for (int i = 0; i < _observers.size(); i++)
+        _observers.at(i)->BeginContact(contact);
+
     for (int i=0; i < _sensors.size(); i++)
     {
         OGSensor* sensor = _sensors.at(i);
@@ -30,6 +33,9 @@ void OGContactListener::EndContact(b2Contact* contact)
     b2Fixture* fixtureA = contact->GetFixtureA();
     b2Fixture* fixtureB = contact->GetFixtureB();
 
+    for (int i = 0; i < _observers.size(); i++)
+        _observers.at(i)->EndContact(contact);
+
     for (int i=0; i < _sensors.size(); i++)
     {
         OGSensor* sensor = _sensors.at(i);
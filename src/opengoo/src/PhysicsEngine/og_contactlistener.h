@@ -4,6 +4,7 @@
 #include <Box2D/Box2D.h>
 
 #include "og_sensor.h"
+#include "og_contactobserver.h"
 
 #include <QList>
 
@@ -18,9 +19,13 @@ class OGContactListener : public b2ContactListener
         void EndContact(b2Contact* contact);
         void AddSensor(OGSensor* sensor) { _sensors << sensor; }
         void RemoveSensor(OGSensor* sensor);
+        int SensorCount() const { return _sensors.size(); }
+        void AddObserver(OGContactObserver* observer) { _observers << observer; }
+        void RemoveObserver(OGContactObserver* observer);
 
     private:                        
         QList<OGSensor*> _sensors;
+        QList<OGContactObserver*> _observers;
 };
 
 inline void OGContactListener::RemoveSensor(OGSensor* sensor)
@@ -29,6 +34,11 @@ inline void OGContactListener::RemoveSensor(OGSensor* sensor)
     if (i != -1) _sensors.removeAt(i);
 }
 
+inline void OGContactListener::RemoveObserver(OGContactObserver* observer)
+{
+    _observers.removeOne(observer);
+}
+
 } // namespace og
 
 #endif // OG_CONTACTLISTENER_H
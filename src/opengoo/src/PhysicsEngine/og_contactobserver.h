@@ -0,0 +1,22 @@
+#ifndef OG_CONTACTOBSERVER_H
+#define OG_CONTACTOBSERVER_H
+
+class b2Contact;
+
+namespace og
+{
+// Hears about every contact which starts or stops touching, where a sensor
+// hears only about its own fixture. Box2D calls EndContact() for the
+// touching contacts of a destroyed body too, so the counts kept by an
+// observer stay balanced.
+class OGContactObserver
+{
+    public:
+        virtual ~OGContactObserver() {}
+
+        virtual void BeginContact(b2Contact* contact) = 0;
+        virtual void EndContact(b2Contact* contact) = 0;
+};
+} // namespace og
+
+#endif // OG_CONTACTOBSERVER_H
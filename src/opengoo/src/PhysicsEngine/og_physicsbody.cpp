@@ -98,3 +98,13 @@ void OGPhysicsBody::SetSensor(bool sensor)
 {
     fixture->SetSensor(sensor);
 }
+
+void OGPhysicsBody::TakeOver(OGPhysicsBody* other)
+{
+    body = other->body;
+    fixture = other->fixture;
+    shape = other->shape;
+    other->shape = 0;
+
+    delete other;
+}
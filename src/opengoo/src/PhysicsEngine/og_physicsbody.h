@@ -3,12 +3,13 @@
 
 #include "common.h"
 #include "og_physicsshape.h"
+#include "GameEngine/memorytracker.h"
 
 class QVector2D;
 
 namespace og
 {
-struct OGPhysicsBody
+struct OGPhysicsBody : Tracked<OGPhysicsBody, MemoryTracker::PHYSICS>
 {
     enum Type {CIRCLE, POLYGON, EDGE, CHAIN};
 
@@ -37,6 +38,10 @@ struct OGPhysicsBody
     void ApplyForce(const b2Vec2 &force, const b2Vec2 &point);
 
     void SetSensor(bool sensor);
+
+    // Takes over the body, fixture and shape created for another object
+    // and deletes it
+    void TakeOver(OGPhysicsBody* other);
 };
 } // namespace og
 
@@ -4,35 +4,40 @@
 #include "og_contactlistener.h"
 
 #include "circle.h"
+#include "GameEngine/metrics.h"
+
+#include <QElapsedTimer>
 
 using namespace og;
 
-OGPhysicsEngine* OGPhysicsEngine::pInstance_ = 0;
+thread_local OGPhysicsEngine* OGPhysicsEngine::pCurrent_ = 0;
 
 OGPhysicsEngine::OGPhysicsEngine()
 {
     pWorld_ = 0;
     pContactListener_ = 0;
+    awakeSampleSteps_ = 0;
     isSleep_ = false;
 }
 
 OGPhysicsEngine::~OGPhysicsEngine()
 {
     _Release();
+
+    if (pCurrent_ == this) pCurrent_ = 0;
 }
 
 OGPhysicsEngine* OGPhysicsEngine::GetInstance()
 {
-    if (!pInstance_) pInstance_ = new OGPhysicsEngine;
-
-    return pInstance_;
+    return pCurrent_;
 }
 
-void OGPhysicsEngine::DestroyInstance(void)
+OGPhysicsEngine* OGPhysicsEngine::SetCurrent(OGPhysicsEngine* engine)
 {
-    if (pInstance_) delete pInstance_;
+    OGPhysicsEngine* previous = pCurrent_;
+    pCurrent_ = engine;
 
-    pInstance_ = 0;
+    return previous;
 }
 
 bool OGPhysicsEngine::Initialize(float x, float y, bool sleep)
@@ -61,13 +66,69 @@ void OGPhysicsEngine::SetGravity(float x, float y)
 void OGPhysicsEngine::SetSimulation(int velIter, int posIter, int steps)
 {
     timeStep_ = 1.0f / steps;
-    velocityIterations_ = velIter;
-    positionIterations_ = posIter;
+    governor_.Reset(velIter, posIter);
+    _UpdateSolverMetrics();
+}
+
+void OGPhysicsEngine::SetSolverLimits(const OGSolverLimits &limits)
+{
+    governor_.SetLimits(limits);
+    _UpdateSolverMetrics();
 }
 
 void OGPhysicsEngine::Simulate()
 {
-    pWorld_->Step(timeStep_, velocityIterations_, positionIterations_);
+    static Metrics::Histogram* stepTime = Metrics::GetHistogram("physics.step_us"
+            , QVector<qint64>() << 250 << 500 << 1000 << 2000 << 4000 << 8000 << 16000);
+    static Metrics::Gauge* contacts = Metrics::GetGauge("physics.contacts");
+    static Metrics::Gauge* bodies = Metrics::GetGauge("physics.bodies");
+    static Metrics::Gauge* awake = Metrics::GetGauge("physics.awake_bodies");
+
+    QElapsedTimer timer;
+    timer.start();
+
+    int substeps = governor_.Substeps();
+    int velocityIterations = governor_.VelocityIterations();
+    int positionIterations = governor_.PositionIterations();
+
+    for (int i = 0; i < substeps; i++)
+    {
+        pWorld_->Step(timeStep_ / substeps, velocityIterations
+                      , positionIterations);
+    }
+
+    qint64 cost = timer.nsecsElapsed() / 1000;
+    stepTime->Record(cost);
+
+    governor_.StepTaken(cost);
+
+    if (governor_.Substeps() != substeps
+            || governor_.VelocityIterations() != velocityIterations
+            || governor_.PositionIterations() != positionIterations)
+    {
+        _UpdateSolverMetrics();
+    }
+    contacts->Set(pWorld_->GetContactCount());
+    bodies->Set(pWorld_->GetBodyCount());
+
+    // Counting walks all the bodies, it's sampled once a second
+    if (++awakeSampleSteps_ >= AWAKE_SAMPLE_STEPS)
+    {
+        awakeSampleSteps_ = 0;
+        int n = 0;
+
+        for (b2Body* b = pWorld_->GetBodyList(); b; b = b->GetNext())
+        {
+            if (b->IsAwake()) n++;
+        }
+
+        awake->Set(n);
+    }
+}
+
+void OGPhysicsEngine::QueryAABB(b2QueryCallback* callback, const b2AABB &aabb)
+{
+    pWorld_->QueryAABB(callback, aabb);
 }
 
 void OGPhysicsEngine::CreateBody(OGPhysicsBody* body)
@@ -75,6 +136,16 @@ void OGPhysicsEngine::CreateBody(OGPhysicsBody* body)
     body->body = pWorld_->CreateBody(&body->bodydef);
 }
 
+b2Body* OGPhysicsEngine::CreateBody(const b2BodyDef &def)
+{
+    return pWorld_->CreateBody(&def);
+}
+
+void OGPhysicsEngine::DestroyBody(b2Body* body)
+{
+    if (body) pWorld_->DestroyBody(body);
+}
+
 void OGPhysicsEngine::CreateJoint(OGPhysicsJoint* joint)
 {
     joint->joint = pWorld_->CreateJoint(joint->jointdef);
@@ -110,11 +181,41 @@ OGContactListener* OGPhysicsEngine::GetContactListener()
 void OGPhysicsEngine::AddSensor(OGSensor* sensor)
 {
     pContactListener_->AddSensor(sensor);
+    _UpdateSensorCount();
 }
 
 void OGPhysicsEngine::RemoveSensor(OGSensor* sensor)
 {
     pContactListener_->RemoveSensor(sensor);
+    _UpdateSensorCount();
+}
+
+void OGPhysicsEngine::AddContactObserver(OGContactObserver* observer)
+{
+    pContactListener_->AddObserver(observer);
+}
+
+void OGPhysicsEngine::RemoveContactObserver(OGContactObserver* observer)
+{
+    pContactListener_->RemoveObserver(observer);
+}
+
+void OGPhysicsEngine::_UpdateSensorCount()
+{
+    static Metrics::Gauge* sensors = Metrics::GetGauge("physics.sensors");
+
+    sensors->Set(pContactListener_->SensorCount());
+}
+
+void OGPhysicsEngine::_UpdateSolverMetrics()
+{
+    static Metrics::Gauge* velocity = Metrics::GetGauge("physics.velocity_iterations");
+    static Metrics::Gauge* position = Metrics::GetGauge("physics.position_iterations");
+    static Metrics::Gauge* substeps = Metrics::GetGauge("physics.substeps");
+
+    velocity->Set(governor_.VelocityIterations());
+    position->Set(governor_.PositionIterations());
+    substeps->Set(governor_.Substeps());
 }
 
 void OGPhysicsEngine::_Init()
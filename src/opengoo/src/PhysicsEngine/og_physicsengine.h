@@ -3,6 +3,7 @@
 
 #include "common.h"
 #include "debug.h"
+#include "og_solvergovernor.h"
 
 class Circle;
 
@@ -15,12 +16,24 @@ struct OGPhysicsJoint;
 
 class OGContactListener;
 class OGSensor;
+class OGContactObserver;
 
+// Each world owns its engine. The engine of the world being simulated on
+// the calling thread is reached through GetInstance(), so the worlds can
+// be stepped on several threads at once. There's no engine for the whole
+// process: a thread which doesn't bind one gets 0.
 class OGPhysicsEngine
 {
     public:
+        OGPhysicsEngine();
+        ~OGPhysicsEngine();
+
+        // The engine bound to the calling thread, 0 if none is bound
         static OGPhysicsEngine* GetInstance(void);
-        static void DestroyInstance(void);
+
+        // Binds the engine to the calling thread (0 unbinds it),
+        // returns the engine bound before
+        static OGPhysicsEngine* SetCurrent(OGPhysicsEngine* engine);
 
         bool Initialize(float x, float y, bool sleep);
         void Reload();
@@ -29,35 +42,53 @@ class OGPhysicsEngine
         void SetSleep(bool sleep) { isSleep_ = sleep; }
 
         void CreateBody(OGPhysicsBody*  body);
+
+        // Bodies which aren't owned by an OGPhysicsBody. They go away with
+        // the world on Reload() if they aren't destroyed before.
+        b2Body* CreateBody(const b2BodyDef &def);
+        void DestroyBody(b2Body* body);
         OGPCircle* CreateCircle(const Circle &circle);
 
         void CreateJoint(OGPhysicsJoint* joint);
         void DestroyJoint(OGPhysicsJoint* joint);
 
         void Simulate();
+        void QueryAABB(b2QueryCallback* callback, const b2AABB &aabb);
+        // The iterations are where the governor starts from,
+        // it keeps them within the solver limits
         void SetSimulation(int velIter, int posIter, int steps);
+        void SetSolverLimits(const OGSolverLimits &limits);
 
         OGContactListener* GetContactListener();
 
         void AddSensor(OGSensor* sensor);
         void RemoveSensor(OGSensor* sensor);
 
+        // The observers are forgotten by Reload()
+        void AddContactObserver(OGContactObserver* observer);
+        void RemoveContactObserver(OGContactObserver* observer);
+
     private:
-        static OGPhysicsEngine* pInstance_;
+        enum { AWAKE_SAMPLE_STEPS = 60 };
+
+        static thread_local OGPhysicsEngine* pCurrent_;
+
         b2World* pWorld_;
         b2Vec2 gravity_;
         float32 timeStep_;
-        int32 velocityIterations_;
-        int32 positionIterations_;
+        int awakeSampleSteps_;
+        OGSolverGovernor governor_;
         bool isSleep_;
 
         OGContactListener* pContactListener_;
 
-        OGPhysicsEngine();
-        ~OGPhysicsEngine();
+        OGPhysicsEngine(const OGPhysicsEngine&);
+        OGPhysicsEngine& operator=(const OGPhysicsEngine&);
 
         void _Init();
         void _Release();
+        void _UpdateSensorCount();
+        void _UpdateSolverMetrics();
 };
 } // namespace og
 
@@ -2,16 +2,18 @@
 #define OG_PHYSICSJOINT_H
 
 #include "common.h"
+#include "GameEngine/memorytracker.h"
 
 namespace og
 {
-struct OGPhysicsJoint
+// The joint definition is only used by OGPhysicsEngine::CreateJoint()
+// and isn't owned by the joint
+struct OGPhysicsJoint : Tracked<OGPhysicsJoint, MemoryTracker::PHYSICS>
 {
     b2JointDef* jointdef;
     b2Joint* joint;
 
     OGPhysicsJoint() : jointdef(0), joint(0) { }
-    ~OGPhysicsJoint() { delete jointdef; }
 };
 }
 
@@ -0,0 +1,126 @@
+#include "og_solvergovernor.h"
+#include "logger.h"
+
+using namespace og;
+
+namespace
+{
+// The cost of the next notch up must stay under this part of the budget
+const float HEADROOM = 0.8f;
+
+// Broadphase, narrowphase and integration, in the units of one iteration
+const float STEP_OVERHEAD = 2.0f;
+}
+
+OGSolverGovernor::OGSolverGovernor()
+    : velocityIterations_(6)
+    , positionIterations_(2)
+    , substeps_(1)
+    , cost_(0)
+    , steps_(0)
+{
+    _Clamp();
+}
+
+void OGSolverGovernor::SetLimits(const OGSolverLimits &limits)
+{
+    limits_ = limits;
+
+    limits_.minVelocityIterations = qMax(limits_.minVelocityIterations, 1);
+    limits_.maxVelocityIterations = qMax(limits_.maxVelocityIterations
+                                         , limits_.minVelocityIterations);
+    limits_.minPositionIterations = qMax(limits_.minPositionIterations, 1);
+    limits_.maxPositionIterations = qMax(limits_.maxPositionIterations
+                                         , limits_.minPositionIterations);
+    limits_.maxSubsteps = qMax(limits_.maxSubsteps, 1);
+
+    _Clamp();
+}
+
+void OGSolverGovernor::Reset(int velocityIterations, int positionIterations)
+{
+    velocityIterations_ = velocityIterations;
+    positionIterations_ = positionIterations;
+    substeps_ = 1;
+    cost_ = 0;
+    steps_ = 0;
+
+    _Clamp();
+}
+
+void OGSolverGovernor::StepTaken(qint64 cost)
+{
+    cost_ += cost;
+
+    if (++steps_ < ADJUST_STEPS) return;
+
+    float average = cost_ / float(steps_) / 1000.0f;
+    cost_ = 0;
+    steps_ = 0;
+
+    bool changed = false;
+
+    if (average > limits_.budget) changed = _Degrade();
+    else changed = _Improve(average);
+
+    if (changed)
+    {
+        logDebugf("Solver: %1 velocity, %2 position iterations, %3 sub-steps"
+                  " (step %4 ms)", velocityIterations_, positionIterations_
+                  , substeps_, average);
+    }
+}
+
+bool OGSolverGovernor::_Degrade()
+{
+    if (substeps_ > 1) substeps_--;
+    else if (positionIterations_ > limits_.minPositionIterations)
+        positionIterations_--;
+    else if (velocityIterations_ > limits_.minVelocityIterations)
+        velocityIterations_--;
+    else
+        return false;
+
+    return true;
+}
+
+bool OGSolverGovernor::_Improve(float cost)
+{
+    int velocity = velocityIterations_;
+    int position = positionIterations_;
+    int substeps = substeps_;
+
+    if (velocity < limits_.maxVelocityIterations) velocity++;
+    else if (position < limits_.maxPositionIterations) position++;
+    else if (substeps < limits_.maxSubsteps) substeps++;
+    else return false;
+
+    // The cost grows about linearly with the work of the solver
+    float next = cost * _Work(velocity, position, substeps)
+                 / _Work(velocityIterations_, positionIterations_, substeps_);
+
+    if (next > limits_.budget * HEADROOM) return false;
+
+    velocityIterations_ = velocity;
+    positionIterations_ = position;
+    substeps_ = substeps;
+
+    return true;
+}
+
+void OGSolverGovernor::_Clamp()
+{
+    velocityIterations_ = qBound(limits_.minVelocityIterations
+                                 , velocityIterations_
+                                 , limits_.maxVelocityIterations);
+    positionIterations_ = qBound(limits_.minPositionIterations
+                                 , positionIterations_
+                                 , limits_.maxPositionIterations);
+    substeps_ = qBound(1, substeps_, limits_.maxSubsteps);
+}
+
+float OGSolverGovernor::_Work(int velocityIterations, int positionIterations
+                              , int substeps)
+{
+    return substeps * (velocityIterations + positionIterations + STEP_OVERHEAD);
+}
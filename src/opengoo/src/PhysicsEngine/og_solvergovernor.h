@@ -0,0 +1,74 @@
+#ifndef OG_SOLVERGOVERNOR_H
+#define OG_SOLVERGOVERNOR_H
+
+#include <QtGlobal>
+
+namespace og
+{
+// Bounds of the solver quality. The minimums are the stability floor of
+// the level, the governor never goes below them whatever the step costs.
+struct OGSolverLimits
+{
+    int minVelocityIterations;
+    int maxVelocityIterations;
+    int minPositionIterations;
+    int maxPositionIterations;
+    int maxSubsteps;
+    float budget; // for one step, in milliseconds
+
+    OGSolverLimits()
+        : minVelocityIterations(4)
+        , maxVelocityIterations(8)
+        , minPositionIterations(2)
+        , maxPositionIterations(3)
+        , maxSubsteps(1)
+        , budget(4.0f)
+    {
+    }
+};
+
+// Keeps the cost of a physics step within the budget. The cost is averaged
+// over ADJUST_STEPS steps, then the quality goes one notch down if it's
+// over the budget, or one notch up if the predicted cost of the next notch
+// leaves some headroom. Going down drops the sub-steps first, then the
+// position and the velocity iterations; going up is the other way round.
+class OGSolverGovernor
+{
+    public:
+        enum { ADJUST_STEPS = 30 };
+
+        OGSolverGovernor();
+
+        // The current values are clamped to the new limits
+        void SetLimits(const OGSolverLimits &limits);
+        const OGSolverLimits& Limits() const { return limits_; }
+
+        // Starts over from the given iterations and one sub-step
+        void Reset(int velocityIterations, int positionIterations);
+
+        // Called after every step with its cost, in microseconds
+        void StepTaken(qint64 cost);
+
+        int VelocityIterations() const { return velocityIterations_; }
+        int PositionIterations() const { return positionIterations_; }
+        int Substeps() const { return substeps_; }
+
+    private:
+        OGSolverLimits limits_;
+        int velocityIterations_;
+        int positionIterations_;
+        int substeps_;
+
+        qint64 cost_;
+        int steps_;
+
+        bool _Degrade();
+        bool _Improve(float cost);
+        void _Clamp();
+
+        static float _Work(int velocityIterations, int positionIterations
+                           , int substeps);
+};
+} // namespace og
+
+#endif // OG_SOLVERGOVERNOR_H
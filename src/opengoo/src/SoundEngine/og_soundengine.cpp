@@ -0,0 +1,289 @@
+#include "og_soundengine.h"
+#include "og_wavdecoder.h"
+#include "OGLib/ringbuffer.h"
+#include "logger.h"
+
+#include <AL/al.h>
+#include <AL/alc.h>
+
+#include <atomic>
+
+#include <QFileInfo>
+#include <QHash>
+#include <QString>
+
+using namespace og;
+
+namespace
+{
+const int QUEUE_SIZE = 1024;
+
+struct SoundRequest
+{
+    ALuint buffer;
+    int group;
+    int priority;
+};
+
+struct Voice
+{
+    ALuint source;
+    int priority;
+    unsigned int serial; // order in which the voices were started
+};
+
+ALenum GetFormat(const OGPcmData &pcm)
+{
+    if (pcm.channels == 1)
+        return pcm.bitsPerSample == 8 ? AL_FORMAT_MONO8 : AL_FORMAT_MONO16;
+
+    return pcm.bitsPerSample == 8 ? AL_FORMAT_STEREO8 : AL_FORMAT_STEREO16;
+}
+}
+
+struct OGSoundEngine::Impl
+{
+    ALCdevice* pDevice;
+    ALCcontext* pContext;
+
+    Voice voices[MAX_VOICES];
+    int numVoices;
+    unsigned int serial;
+
+    QHash<QString, ALuint> buffers;
+
+    int limits[MAX_GROUPS];
+    int played[MAX_GROUPS];
+
+    oglib::RingBuffer<SoundRequest, QUEUE_SIZE> queue;
+    std::atomic_flag isPushing; // a second producer is caught by Play()
+};
+
+OGSoundEngine* OGSoundEngine::pInstance_ = 0;
+
+OGSoundEngine::OGSoundEngine() : _pImpl(new Impl)
+{
+    _pImpl->pDevice = 0;
+    _pImpl->pContext = 0;
+    _pImpl->numVoices = 0;
+    _pImpl->serial = 0;
+    _pImpl->isPushing.clear();
+
+    for (int i = 0; i < MAX_GROUPS; i++)
+    {
+        _pImpl->limits[i] = DEFAULT_GROUP_LIMIT;
+        _pImpl->played[i] = 0;
+    }
+}
+
+OGSoundEngine::~OGSoundEngine()
+{
+    _Release();
+}
+
+OGSoundEngine* OGSoundEngine::GetInstance()
+{
+    if (!pInstance_) pInstance_ = new OGSoundEngine;
+
+    return pInstance_;
+}
+
+void OGSoundEngine::DestroyInstance(void)
+{
+    if (pInstance_) delete pInstance_;
+
+    pInstance_ = 0;
+}
+
+bool OGSoundEngine::Initialize()
+{
+    if (isInitialized()) return true;
+
+    _pImpl->pDevice = alcOpenDevice(0);
+
+    if (!_pImpl->pDevice)
+    {
+        logWarn("Unable to open the audio device");
+        return false;
+    }
+
+    _pImpl->pContext = alcCreateContext(_pImpl->pDevice, 0);
+
+    if (!_pImpl->pContext || !alcMakeContextCurrent(_pImpl->pContext))
+    {
+        logWarn("Unable to create the audio context");
+        _Release();
+        return false;
+    }
+
+    alGetError();
+
+    for (int i = 0; i < MAX_VOICES; i++)
+    {
+        ALuint source;
+        alGenSources(1, &source);
+
+        if (alGetError() != AL_NO_ERROR) break;
+
+        _pImpl->voices[i].source = source;
+        _pImpl->voices[i].priority = 0;
+        _pImpl->voices[i].serial = 0;
+        _pImpl->numVoices++;
+    }
+
+    logInfo(QString("Sound engine: %1 voices").arg(_pImpl->numVoices));
+
+    return true;
+}
+
+bool OGSoundEngine::isInitialized() const
+{
+    return _pImpl->pContext != 0;
+}
+
+unsigned int OGSoundEngine::LoadSound(const QString &filename)
+{
+    if (!isInitialized() || filename.isEmpty()) return 0;
+
+    QString path = filename;
+
+    if (QFileInfo(path).suffix().isEmpty())
+        path += ".wav";
+
+    QHash<QString, ALuint>::const_iterator it = _pImpl->buffers.find(path);
+
+    if (it != _pImpl->buffers.end()) return it.value();
+
+    OGPcmData pcm;
+    ALuint buffer = 0;
+
+    if (OGWavDecoder::Decode(path, &pcm))
+    {
+        alGetError();
+        alGenBuffers(1, &buffer);
+        alBufferData(buffer, GetFormat(pcm), pcm.samples.constData()
+                     , pcm.samples.size(), pcm.frequency);
+
+        if (alGetError() != AL_NO_ERROR)
+        {
+            logWarn("Unable to create a sound buffer for " + path);
+            alDeleteBuffers(1, &buffer);
+            buffer = 0;
+        }
+    }
+
+    // Failed sounds are cached too, so they aren't decoded again
+    _pImpl->buffers.insert(path, buffer);
+
+    return buffer;
+}
+
+bool OGSoundEngine::Play(unsigned int buffer, int group, int priority)
+{
+    if (buffer == 0 || group < 0 || group >= MAX_GROUPS) return false;
+
+    SoundRequest request = {buffer, group, priority};
+
+    bool isPushing = _pImpl->isPushing.test_and_set(std::memory_order_acquire);
+    Q_ASSERT_X(!isPushing, "OGSoundEngine::Play", "more than one producer");
+    Q_UNUSED(isPushing)
+
+    bool isQueued = _pImpl->queue.Push(request);
+    _pImpl->isPushing.clear(std::memory_order_release);
+
+    return isQueued;
+}
+
+void OGSoundEngine::SetGroupLimit(int group, int limit)
+{
+    if (group >= 0 && group < MAX_GROUPS) _pImpl->limits[group] = limit;
+}
+
+void OGSoundEngine::Update()
+{
+    for (int i = 0; i < MAX_GROUPS; i++)
+    {
+        _pImpl->played[i] = 0;
+    }
+
+    SoundRequest request;
+
+    // Requests over the limit are dropped, the queue is always emptied
+    while (_pImpl->queue.Pop(&request))
+    {
+        if (_pImpl->played[request.group] >= _pImpl->limits[request.group])
+            continue;
+
+        _pImpl->played[request.group]++;
+        _Start(request.buffer, request.priority);
+    }
+}
+
+void OGSoundEngine::_Start(unsigned int buffer, int priority)
+{
+    Voice* voice = 0;
+    Voice* victim = 0;
+
+    for (int i = 0; i < _pImpl->numVoices; i++)
+    {
+        Voice* v = &_pImpl->voices[i];
+        ALint state;
+        alGetSourcei(v->source, AL_SOURCE_STATE, &state);
+
+        if (state != AL_PLAYING)
+        {
+            voice = v;
+            break;
+        }
+
+        if (!victim || v->priority < victim->priority
+                || (v->priority == victim->priority && v->serial < victim->serial))
+        {
+            victim = v;
+        }
+    }
+
+    if (!voice)
+    {
+        if (!victim || victim->priority > priority) return;
+
+        voice = victim;
+        alSourceStop(voice->source);
+    }
+
+    voice->priority = priority;
+    voice->serial = ++_pImpl->serial;
+    alSourcei(voice->source, AL_BUFFER, buffer);
+    alSourcePlay(voice->source);
+}
+
+void OGSoundEngine::_Release()
+{
+    for (int i = 0; i < _pImpl->numVoices; i++)
+    {
+        alSourceStop(_pImpl->voices[i].source);
+        alDeleteSources(1, &_pImpl->voices[i].source);
+    }
+
+    _pImpl->numVoices = 0;
+
+    Q_FOREACH(ALuint buffer, _pImpl->buffers)
+    {
+        if (buffer) alDeleteBuffers(1, &buffer);
+    }
+
+    _pImpl->buffers.clear();
+
+    if (_pImpl->pContext)
+    {
+        alcMakeContextCurrent(0);
+        alcDestroyContext(_pImpl->pContext);
+        _pImpl->pContext = 0;
+    }
+
+    if (_pImpl->pDevice)
+    {
+        alcCloseDevice(_pImpl->pDevice);
+        _pImpl->pDevice = 0;
+    }
+}
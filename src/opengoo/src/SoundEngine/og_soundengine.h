@@ -0,0 +1,64 @@
+#ifndef OG_SOUNDENGINE_H
+#define OG_SOUNDENGINE_H
+
+#include <memory>
+
+class QString;
+
+namespace og
+{
+// Sound effects are decoded once into shared OpenAL buffers and played on a
+// fixed pool of sources. Play() only pushes a request into a lock-free queue,
+// so it can be called from the simulation as often as it likes; Update()
+// drains the queue once per frame, applies the per-group rate limit and
+// steals the lowest priority voice when the pool is exhausted.
+class OGSoundEngine
+{
+    public:
+        enum
+        {
+            MAX_VOICES = 16,
+            MAX_GROUPS = 32,
+            DEFAULT_GROUP_LIMIT = 2
+        };
+
+        static OGSoundEngine* GetInstance(void);
+        static void DestroyInstance(void);
+
+        bool Initialize();
+        bool isInitialized() const;
+
+        // Returns the buffer id of a decoded sound, 0 if it can't be loaded.
+        // Each file is decoded only once.
+        unsigned int LoadSound(const QString &filename);
+
+        // The queue has a single producer: Play() may be called from one
+        // thread at a time, the simulation's while it runs. Two threads
+        // playing at once trip an assert.
+        bool Play(unsigned int buffer, int group, int priority);
+
+        // How many sounds of the group may start in one frame
+        void SetGroupLimit(int group, int limit);
+
+        void Update();
+
+    private:
+        static OGSoundEngine* pInstance_;
+
+        struct Impl;
+        std::unique_ptr<Impl> _pImpl;
+
+        OGSoundEngine();
+        ~OGSoundEngine();
+
+        OGSoundEngine(const OGSoundEngine&);
+        OGSoundEngine& operator=(const OGSoundEngine&);
+
+        void _Start(unsigned int buffer, int priority);
+        void _Release();
+};
+} // namespace og
+
+typedef og::OGSoundEngine SEngine;
+
+#endif // OG_SOUNDENGINE_H
@@ -0,0 +1,93 @@
+#include "og_wavdecoder.h"
+#include "logger.h"
+
+#include <QFile>
+#include <QtEndian>
+
+using namespace og;
+
+namespace
+{
+const quint16 WAVE_FORMAT_PCM = 1;
+
+inline quint32 ReadU32(const char* p)
+{
+    return qFromLittleEndian<quint32>(reinterpret_cast<const uchar*>(p));
+}
+
+inline quint16 ReadU16(const char* p)
+{
+    return qFromLittleEndian<quint16>(reinterpret_cast<const uchar*>(p));
+}
+}
+
+bool OGWavDecoder::Decode(const QString &filename, OGPcmData* pcm)
+{
+    QFile file(filename);
+
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        logWarn("File " + filename + " not found");
+        return false;
+    }
+
+    QByteArray data = file.readAll();
+    const char* p = data.constData();
+    const int size = data.size();
+
+    if (size < 12 || qstrncmp(p, "RIFF", 4) || qstrncmp(p + 8, "WAVE", 4))
+    {
+        logWarn("File " + filename + " is not a WAVE file");
+        return false;
+    }
+
+    bool isFormat = false;
+    int pos = 12;
+
+    while (pos + 8 <= size)
+    {
+        const char* chunk = p + pos;
+        int length = ReadU32(chunk + 4);
+        int body = pos + 8;
+
+        if (length < 0 || body + length > size)
+            length = size - body;
+
+        if (!qstrncmp(chunk, "fmt ", 4) && length >= 16)
+        {
+            if (ReadU16(p + body) != WAVE_FORMAT_PCM)
+            {
+                logWarn("File " + filename + " is not PCM encoded");
+                return false;
+            }
+
+            pcm->channels = ReadU16(p + body + 2);
+            pcm->frequency = ReadU32(p + body + 4);
+            pcm->bitsPerSample = ReadU16(p + body + 14);
+            isFormat = true;
+        }
+        else if (!qstrncmp(chunk, "data", 4) && isFormat)
+        {
+            pcm->samples = data.mid(body, length);
+            break;
+        }
+
+        // chunks are word aligned
+        pos = body + length + (length & 1);
+    }
+
+    if (!isFormat || pcm->samples.isEmpty())
+    {
+        logWarn("File " + filename + " is corrupted");
+        return false;
+    }
+
+    if ((pcm->channels != 1 && pcm->channels != 2)
+            || (pcm->bitsPerSample != 8 && pcm->bitsPerSample != 16))
+    {
+        logWarn("File " + filename + " has unsupported sample format");
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,28 @@
+#ifndef OG_WAVDECODER_H
+#define OG_WAVDECODER_H
+
+#include <QByteArray>
+
+class QString;
+
+namespace og
+{
+struct OGPcmData
+{
+    QByteArray samples;
+    int channels;
+    int bitsPerSample;
+    int frequency;
+
+    OGPcmData() : channels(0), bitsPerSample(0), frequency(0) {}
+};
+
+class OGWavDecoder
+{
+    public:
+        // Decodes an uncompressed RIFF/WAVE (8 or 16 bit PCM) file
+        static bool Decode(const QString &filename, OGPcmData* pcm);
+};
+} // namespace og
+
+#endif // OG_WAVDECODER_H
@@ -1,17 +1,70 @@
 #include "backtracer.h"
 #include <execinfo.h>
+#include <unistd.h>
+#include <sys/wait.h>
 #ifdef __FreeBSD__
 #	include <ucontext.h>
 #endif
 
-#include <QDebug>
 #include <logger.h>
-#include <QString>
-#include <QProcess>
 
 static void SignalHandler(int32_t sig, siginfo_t *info, void *scp);
 
+namespace
+{
+// Only async-signal-safe calls from here on: no locks, no allocations,
+// so the report isn't formatted by Qt and OpenGooDst isn't started by
+// QProcess
+void WriteString(const char *str){
+    size_t len = 0;
+
+    while (str[len])
+        len++;
+
+    ssize_t n = write(STDERR_FILENO, str, len);
+    (void)n;
+}
+
+void WriteNumber(unsigned long value, unsigned base){
+    char buf[32];
+    int i = sizeof(buf) - 1;
+    buf[i] = '\0';
+
+    do {
+        buf[--i] = "0123456789abcdef"[value % base];
+        value /= base;
+    } while (value && i > 0);
+
+    WriteString(buf + i);
+}
+
+// At crash OpenGooDst is launched
+void StartReporter(){
+    static char program[] = "./OpenGooDst";
+    static char * const arguments[] = { program, NULL };
+
+    pid_t pid = fork();
+
+    if (pid == 0)
+    {
+        execv(program, arguments);
+        _exit(127);
+    }
+
+    if (pid > 0)
+    {
+        int status;
+        waitpid(pid, &status, 0);
+    }
+}
+}
+
 void BackTracer(int32_t sig){
+    // The first backtrace() loads libgcc, which allocates; it mustn't
+    // happen in the handler
+    void * array[1];
+    backtrace(array, 1);
+
     struct sigaction sa;
     sa.sa_sigaction = SignalHandler;
     sigemptyset (&sa.sa_mask);
@@ -20,43 +73,29 @@ void BackTracer(int32_t sig){
 }
 
 static void SignalHandler(int32_t sig, siginfo_t *info, void *scp){
-    void * array[64];
-    int32_t nSize = backtrace(array, 64);
-    char ** symbols = backtrace_symbols(array, nSize);
     ucontext_t * ucx = static_cast<ucontext_t*>(scp);
 
-    QString backtraceText;
-    QTextStream backtraceStream(&backtraceText);
-
-    backtraceStream << "signal " << sig << " si_code " << info->si_code << " si_addr " << hex
-        << info->si_addr << dec << " ss_sp "
-        << ucx->uc_stack.ss_sp;
-
-    for (int32_t i = 2; i < nSize; i++)
-        backtraceStream<<symbols[i];
-
-    free(symbols);
-    signal(SIGABRT, SIG_DFL);
-
-    //At crash the report is generated and OpenGooDst is launched.
+    // The log lines still queued for the writer thread, the console
+    // appenders write to stdout
+    LoggerEngine::flushToFd(STDOUT_FILENO);
 
-    //CrashXmlModule *reportModule = new CrashXmlModule(backtraceText);
-    //QUuid reportQUuid = reportModule->getUuid();
+    WriteString("signal ");
+    WriteNumber(sig, 10);
+    WriteString(" si_code ");
+    WriteNumber(info->si_code, 10);
+    WriteString(" si_addr 0x");
+    WriteNumber(reinterpret_cast<unsigned long>(info->si_addr), 16);
+    WriteString(" ss_sp 0x");
+    WriteNumber(reinterpret_cast<unsigned long>(ucx->uc_stack.ss_sp), 16);
+    WriteString("\n");
 
-    //logWarn(QString("back Report quuid %1").arg(reportQUuid.toString()));
-
-    QProcess *myProcess = new QProcess;
-
-    QString program = "./OpenGooDst";
-    QStringList arguments;
-    //arguments << "-w" << "-Uuid=" + reportQUuid.toString();
-
-    myProcess->start(program, arguments);
+    void * array[64];
+    int32_t nSize = backtrace(array, 64);
 
-    myProcess->waitForFinished();
+    if (nSize > 2)
+        backtrace_symbols_fd(array + 2, nSize - 2, STDERR_FILENO);
 
-    //delete reportModule;
+    StartReporter();
 
-    exit(sig);
+    _exit(sig);
 }
-
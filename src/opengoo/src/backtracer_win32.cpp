@@ -5,6 +5,7 @@
 */
 
 #include "backtracer_win32.h"
+#include <logger.h>
 #include <tchar.h>
 #include <psapi.h>
 #include <iostream>
@@ -297,6 +298,7 @@ LONG WINAPI UnhandledException2(LPEXCEPTION_POINTERS exceptionInfo)
     if(exceptionInfo->ExceptionRecord->ExceptionCode == MS_VC_EXCEPTION)
         return EXCEPTION_EXECUTE_HANDLER;
 
+    LoggerEngine::flush();
     save_dump(exceptionInfo);
     save_stack();
     switch(exceptionInfo->ExceptionRecord->ExceptionCode)
@@ -6,28 +6,29 @@
 #include "circle.h"
 #include "physics.h"
 
-#include "opengoo.h"
 #include "og_world.h"
-#include "og_userdata.h"
 
 using namespace og;
 
 struct Exit::Impl
 {
+    OGWorld* pWorld;
     ExitSensor* pSensor;
     int balls;
     bool isClosed;
 };
 
-Exit::Exit(WOGLevelExit* exit) : _pImpl(new Impl)
-{       
+Exit::Exit(WOGLevelExit* exit, OGWorld* world) : _pImpl(new Impl)
+{
+    _pImpl->pWorld = world;
+
     // [1] Create sensor
     Circle c = Circle(exit->pos, exit->radius) / 10.0f;
     OGSensorFilter f = {physics::EXIT, physics::BALL};
-    _pImpl->pSensor = new ExitSensor(c, f);
+    _pImpl->pSensor = new ExitSensor(c, f, world);
 
     // [2] Add sensor
-    PEngine::GetInstance()->AddSensor(_pImpl->pSensor);
+    world->physics()->AddSensor(_pImpl->pSensor);
 
     _pImpl->balls = 0;
 
@@ -36,7 +37,7 @@ Exit::Exit(WOGLevelExit* exit) : _pImpl(new Impl)
 
 Exit::~Exit()
 {
-    PEngine::GetInstance()->RemoveSensor(_pImpl->pSensor);
+    _pImpl->pWorld->physics()->RemoveSensor(_pImpl->pSensor);
 
     delete _pImpl->pSensor;
 }
@@ -46,45 +47,31 @@ void Exit::Update()
     if (_pImpl->isClosed) return;
 
     QVector2D center = _pImpl->pSensor->GetPosition();
-    OpenGOO* game = OpenGOO::instance();
-    QList<OGBall*> balls = game->GetWorld()->balls();
 
-    Q_FOREACH(OGBall * ball, balls)
+    // A copy, a ball reaching the exit ends its contact with the sensor
+    Q_FOREACH(OGBall * ball, _pImpl->pSensor->ActiveBalls())
     {
         if (ball->isExit()) continue;
 
-        OGUserData* userData = ball->GetUserData();
+        QVector2D position = ball->GetCenter();
+        QVector2D d = center - position;
 
-        if (userData && userData->isTouching)
+        if (ball->isSuction() && d.lengthSquared() <= 1.0f)
         {
-            QVector2D position = ball->GetCenter();
-            QVector2D d = center - position;
+            _pImpl->balls++;
+            ball->SetExit(true);
+            continue;
+        }
 
-            float force = 40.0f;
+        if (d.lengthSquared() < FLT_EPSILON * FLT_EPSILON) continue;
 
-            if (d.lengthSquared() < FLT_EPSILON * FLT_EPSILON)
-            {
-                continue;
-            }
+        float force = 40.0f;
 
-            d.normalize();
+        d.normalize();
 
-            QVector2D F =  force * d;
+        QVector2D F =  force * d;
 
-            ball->ApplyForce(F, position);
-        }
-
-        if (ball->isSuction())
-        {
-            QVector2D position = ball->GetCenter();
-            float lq = (center - position).lengthSquared();
-
-            if (lq <= 1.0f)
-            {
-                _pImpl->balls++;
-                ball->SetExit(true);
-            }
-        }
+        ball->ApplyForce(F, position);
     }
 }
 
@@ -93,14 +80,12 @@ int Exit::Balls() const { return _pImpl->balls; }
 void Exit::Close()
 {
     _pImpl->isClosed = true;
-    PEngine::GetInstance()->RemoveSensor(_pImpl->pSensor);
-    OpenGOO* game = OpenGOO::instance();
-    QList<OGBall*> balls = game->GetWorld()->balls();
+    _pImpl->pWorld->physics()->RemoveSensor(_pImpl->pSensor);
 
-    Q_FOREACH(OGBall * ball, balls)
+    Q_FOREACH(OGBall * ball, _pImpl->pSensor->ActiveBalls())
     {
         ball->SetSuction(false);
     }
 
-    game->ClosePipe();
+    _pImpl->pWorld->ClosePipe();
 }
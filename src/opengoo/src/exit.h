@@ -4,11 +4,12 @@
 #include <memory>
 
 struct WOGLevelExit;
+class OGWorld;
 
 class Exit
 {
     public:
-        Exit(WOGLevelExit* exit);
+        Exit(WOGLevelExit* exit, OGWorld* world);
         ~Exit();
         void Update();        
         int Balls() const;
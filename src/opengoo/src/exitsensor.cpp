@@ -1,13 +1,25 @@
 #include "exitsensor.h"
 #include "circle.h"
-#include "opengoo.h"
+#include "og_world.h"
 #include "og_userdata.h"
+#include "GameEngine/metrics.h"
 
 using namespace og;
 
+namespace
+{
+void UpdateMetrics(int balls)
+{
+    static Metrics::Gauge* active = Metrics::GetGauge("exit.active_balls");
+
+    active->Set(balls);
+}
+}
+
 ExitSensor::ExitSensor(const Circle &circle
-                       , const OGSensorFilter &filter)
+                       , const OGSensorFilter &filter, OGWorld* world)
     : OGCircleSensor(circle)
+    , pWorld_(world)
     , balls_(0)
     , isClosed_(true)
 {
@@ -36,13 +48,16 @@ void ExitSensor::_BeginContact(Fixture* fixture)
                 if (balls_ == 1) _OpenPipe();
 
                 data->isTouching = true;
-
+                activeBalls_ << ball;
             }
-            else if (!isClosed_ && ball->IsSuckable())
+            else if (!isClosed_ && ball->IsSuckable() && !data->isTouching)
             {
                 data->isTouching = true;
                 ball->SetSuction(true);                
+                activeBalls_ << ball;
             }
+
+            UpdateMetrics(activeBalls_.size());
         }
     }
 }
@@ -68,25 +83,29 @@ void ExitSensor::_EndContact(Fixture* fixture)
                 if (balls_ == 0) _ClosePipe();
 
                 data->isTouching = false;
+                activeBalls_.removeOne(ball);
             }
             else if (ball->IsSuckable())
             {
                 data->isTouching = false;
                 ball->SetSuction(false);
+                activeBalls_.removeOne(ball);
             }
+
+            UpdateMetrics(activeBalls_.size());
         }
     }
 }
 
 inline void ExitSensor::_OpenPipe()
 {
-    OpenGOO::instance()->OpenPipe();
+    pWorld_->OpenPipe();
     isClosed_ = false;
 }
 
 inline void ExitSensor::_ClosePipe()
 {
-    OpenGOO::instance()->ClosePipe();
+    pWorld_->ClosePipe();
     isClosed_ = true;
 }
 
@@ -3,18 +3,29 @@
 
 #include <OGCircleSensor>
 
+#include <QList>
+
 class OGBall;
+class OGWorld;
 
 class ExitSensor : public og::OGCircleSensor
 {
     public:
         ExitSensor(const Circle &circle
-                   , const og::OGSensorFilter &filter);
+                   , const og::OGSensorFilter &filter, OGWorld* world);
         ~ExitSensor() {}
 
+        // The balls in range which the exit pulls in: the attached balls
+        // which opened the pipe and the suckable balls while it's open.
+        // A ball leaves the list with its contact, which also ends when
+        // its body is deactivated, e.g. by OGBall::SetExit().
+        const QList<OGBall*>& ActiveBalls() const { return activeBalls_; }
+
     private:
+        OGWorld* pWorld_;
         int balls_;
         bool isClosed_;
+        QList<OGBall*> activeBalls_;
 
         void _BeginContact(Fixture* fixture);
         void _EndContact(Fixture* fixture);
@@ -87,7 +87,7 @@ unique_ptr<PushButton> GameMenu::_createButton(const WOGButton* button
 inline QPixmap* GameMenu::_getImage(const QString &id
                                     , const WOGResources &resrc)
 {
-    return new QPixmap(resrc.GetImage(id));
+    return getImage(id, resrc);
 }
 
 void GameMenu::_restart()
@@ -0,0 +1,295 @@
+#include "og_animation.h"
+
+#include <logger.h>
+
+#include <QFile>
+#include <QtEndian>
+#include <QtCore/qmath.h>
+
+#include <cstring>
+
+namespace
+{
+// The file is a dump of the game's structures, little-endian with 32-bit
+// offsets from the start of the file in place of the pointers
+enum
+{
+    HAS_ALPHA = 4,
+    HAS_TRANSFORM = 12,
+    TRANSFORM_COUNT = 16,
+    FRAME_COUNT = 20,
+    TRANSFORM_TYPES = 24,
+    FRAME_TIMES = 28,
+    TRANSFORM_FRAMES = 32,
+    ALPHA_FRAMES = 36,
+    HEADER_SIZE = 52
+};
+
+// keyframe: x, y, angle, alpha, color, nextFrameIndex, soundStrIdx,
+// interpolation
+enum
+{
+    KEY_X = 0,
+    KEY_Y = 4,
+    KEY_ANGLE = 8,
+    KEY_ALPHA = 12,
+    KEY_NEXT = 20,
+    KEY_INTERPOLATION = 28
+};
+
+enum TransformType { SCALE, ROTATE, TRANSLATE, ALPHA };
+enum Interpolation { NONE, LINEAR };
+
+const int MAX_TRANSFORMS = 16;
+const int MAX_FRAMES = 4096;
+const float MAX_PERIOD = 600.0f; // in seconds
+
+struct Key
+{
+    float x;
+    float y;
+    float angle;
+    float alpha;
+    int next;
+    int interpolation;
+};
+
+// The keyframes of one transform, a frame may have none
+struct Track
+{
+    TransformType type;
+    QVector<int> frames; // which have a keyframe, in order
+    QVector<Key> keys;   // one per frame
+};
+
+class Reader
+{
+    public:
+        explicit Reader(const QByteArray &data) : data_(data), isValid_(true) {}
+
+        bool IsValid() const { return isValid_; }
+
+        qint32 Int(int offset)
+        {
+            if (offset < 0 || offset > data_.size() - 4)
+            {
+                isValid_ = false;
+                return 0;
+            }
+
+            return qFromLittleEndian<qint32>(
+                       reinterpret_cast<const uchar*>(data_.constData()) + offset);
+        }
+
+        float Float(int offset)
+        {
+            qint32 i = Int(offset);
+            float f;
+            memcpy(&f, &i, sizeof(f));
+
+            return f;
+        }
+
+    private:
+        const QByteArray &data_;
+        bool isValid_;
+};
+
+// frames is the offset of an array of the offsets of the keyframes
+bool ReadTrack(Reader* reader, int frames, int count, Track* track)
+{
+    track->keys.resize(count);
+
+    for (int i = 0; i < count; i++)
+    {
+        int offset = reader->Int(frames + i * 4);
+
+        if (offset == 0) continue;
+
+        Key &key = track->keys[i];
+        key.x = reader->Float(offset + KEY_X);
+        key.y = reader->Float(offset + KEY_Y);
+        key.angle = reader->Float(offset + KEY_ANGLE);
+        key.alpha = reader->Int(offset + KEY_ALPHA) / 255.0f;
+        key.next = reader->Int(offset + KEY_NEXT);
+        key.interpolation = reader->Int(offset + KEY_INTERPOLATION);
+
+        if (key.next < 0 || key.next >= count) key.next = i;
+
+        track->frames << i;
+    }
+
+    return reader->IsValid();
+}
+
+inline float Lerp(float a, float b, float u)
+{
+    return a + (b - a) * u;
+}
+
+// The key in effect at the time t and the next one, blended
+Key Sample(const Track &track, const QVector<float> &times, float t
+           , float period)
+{
+    int frame = track.frames.last(); // the last key carries over the wrap
+
+    for (int i = 0; i < track.frames.size(); i++)
+    {
+        if (times.at(track.frames.at(i)) > t) break;
+
+        frame = track.frames.at(i);
+    }
+
+    Key key = track.keys.at(frame);
+
+    if (key.interpolation != LINEAR || key.next == frame
+            || !track.frames.contains(key.next))
+    {
+        return key;
+    }
+
+    const Key &next = track.keys.at(key.next);
+    float t0 = times.at(frame);
+    float t1 = times.at(key.next);
+
+    if (t < t0) t += period;
+    if (t1 <= t0) t1 += period;
+
+    float u = qBound(0.0f, (t - t0) / (t1 - t0), 1.0f);
+
+    key.x = Lerp(key.x, next.x, u);
+    key.y = Lerp(key.y, next.y, u);
+    key.angle = Lerp(key.angle, next.angle, u);
+    key.alpha = Lerp(key.alpha, next.alpha, u);
+
+    return key;
+}
+
+void Bake(const QList<Track> &tracks, const QVector<float> &times
+          , OGAnimation* anim)
+{
+    float period = times.last();
+    anim->count = qMax(1, qCeil(period * OGAnimation::SAMPLE_RATE));
+
+    anim->x.fill(0.0f, anim->count);
+    anim->y.fill(0.0f, anim->count);
+    anim->angle.fill(0.0f, anim->count);
+    anim->scaleX.fill(1.0f, anim->count);
+    anim->scaleY.fill(1.0f, anim->count);
+    anim->alpha.fill(1.0f, anim->count);
+
+    for (int i = 0; i < anim->count; i++)
+    {
+        float t = i / float(OGAnimation::SAMPLE_RATE);
+
+        Q_FOREACH(const Track & track, tracks)
+        {
+            Key key = Sample(track, times, t, period);
+
+            switch (track.type)
+            {
+            case SCALE:
+                anim->scaleX[i] *= key.x;
+                anim->scaleY[i] *= key.y;
+                break;
+
+            case ROTATE:
+                anim->angle[i] += key.angle;
+                break;
+
+            case TRANSLATE:
+                // The file is in the level coordinates
+                anim->x[i] += key.x;
+                anim->y[i] -= key.y;
+                break;
+
+            case ALPHA:
+                anim->alpha[i] = key.alpha;
+                break;
+            }
+        }
+    }
+}
+}
+
+OGAnimation* OGAnimation::Load(const QString &path)
+{
+    QFile file(path);
+
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        logWarn("File " + path + " not found");
+        return 0;
+    }
+
+    QByteArray data = file.readAll();
+    Reader reader(data);
+
+    int transforms = reader.Int(HAS_TRANSFORM) ? reader.Int(TRANSFORM_COUNT) : 0;
+    int frames = reader.Int(FRAME_COUNT);
+
+    if (data.size() < HEADER_SIZE || transforms < 0
+            || transforms > MAX_TRANSFORMS || frames < 1 || frames > MAX_FRAMES)
+    {
+        logWarn("File " + path + " is corrupted");
+        return 0;
+    }
+
+    QVector<float> times(frames);
+    int offset = reader.Int(FRAME_TIMES);
+    bool isSorted = true;
+
+    for (int i = 0; i < frames; i++)
+    {
+        times[i] = reader.Float(offset + i * 4);
+
+        // Also false for a NaN
+        if (i > 0 && !(times.at(i) >= times.at(i - 1))) isSorted = false;
+    }
+
+    QList<Track> tracks;
+    int types = reader.Int(TRANSFORM_TYPES);
+    int transformFrames = reader.Int(TRANSFORM_FRAMES);
+
+    for (int i = 0; i < transforms; i++)
+    {
+        Track track;
+        int type = reader.Int(types + i * 4);
+
+        if (type < SCALE || type > TRANSLATE) continue;
+
+        track.type = TransformType(type);
+
+        if (!ReadTrack(&reader, reader.Int(transformFrames + i * 4), frames
+                       , &track))
+        {
+            break;
+        }
+
+        if (!track.frames.isEmpty()) tracks << track;
+    }
+
+    if (reader.Int(HAS_ALPHA))
+    {
+        Track track;
+        track.type = ALPHA;
+
+        if (ReadTrack(&reader, reader.Int(ALPHA_FRAMES), frames, &track)
+                && !track.frames.isEmpty())
+        {
+            tracks << track;
+        }
+    }
+
+    if (!reader.IsValid() || !isSorted || !(times.first() >= 0)
+            || !(times.last() <= MAX_PERIOD))
+    {
+        logWarn("File " + path + " is corrupted");
+        return 0;
+    }
+
+    OGAnimation* anim = new OGAnimation;
+    Bake(tracks, times, anim);
+
+    return anim;
+}
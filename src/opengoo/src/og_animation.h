@@ -0,0 +1,32 @@
+#ifndef OG_ANIMATION_H
+#define OG_ANIMATION_H
+
+#include <QString>
+#include <QVector>
+
+// The keyframes of a res/anim/*.anim.binltl file baked into the transform
+// of a sprite, sampled SAMPLE_RATE times a second over one period of the
+// animation. Playing it back is a lookup, the keyframes aren't kept.
+//
+// The transforms of the file are combined into an offset of the position,
+// a rotation, a scale and an alpha, which is all a sprite has.
+struct OGAnimation
+{
+    enum { SAMPLE_RATE = 60 };
+
+    int count; // samples
+
+    QVector<float> x; // offset, in the scene coordinates
+    QVector<float> y;
+    QVector<float> angle; // in degrees
+    QVector<float> scaleX;
+    QVector<float> scaleY;
+    QVector<float> alpha;
+
+    OGAnimation() : count(0) {}
+
+    // Returns 0 if the file is missing or corrupted
+    static OGAnimation* Load(const QString &path);
+};
+
+#endif // OG_ANIMATION_H
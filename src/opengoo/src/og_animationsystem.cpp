@@ -0,0 +1,146 @@
+#include "og_animationsystem.h"
+#include "og_animation.h"
+#include "og_renderstats.h"
+#include "og_sprite.h"
+
+#include <QPainter>
+#include <QtCore/qmath.h>
+
+#include <algorithm>
+
+namespace
+{
+const float MAX_DT = 0.1f; // a stall doesn't skip a part of the animation
+
+inline bool DepthLess(float depth, const OGSprite* sprite)
+{
+    return depth < sprite->GetDepth();
+}
+
+inline bool SpriteLess(const OGSprite* sprite, float depth)
+{
+    return sprite->GetDepth() < depth;
+}
+}
+
+OGAnimationSystem::OGAnimationSystem()
+{
+}
+
+OGAnimationSystem::~OGAnimationSystem()
+{
+    Clear();
+    qDeleteAll(animations_);
+}
+
+void OGAnimationSystem::Clear()
+{
+    depths_.clear();
+    sprites_.clear();
+    animation_.clear();
+    phase_.clear();
+    speed_.clear();
+    x_.clear();
+    y_.clear();
+    angle_.clear();
+    scaleX_.clear();
+    scaleY_.clear();
+    alpha_.clear();
+}
+
+bool OGAnimationSystem::Add(OGSprite* sprite, const QString &name, float speed)
+{
+    const OGAnimation* animation = _GetAnimation(name);
+
+    if (!animation) return false;
+
+    float depth = sprite->GetDepth();
+
+    // After the sprites of the same depth, they are painted in this order
+    int i = std::upper_bound(sprites_.begin(), sprites_.end(), depth
+                             , DepthLess) - sprites_.begin();
+
+    sprites_.insert(i, sprite);
+    animation_.insert(i, animation);
+    phase_.insert(i, 0.0f);
+    speed_.insert(i, speed * OGAnimation::SAMPLE_RATE);
+    x_.insert(i, sprite->GetX());
+    y_.insert(i, sprite->GetY());
+    angle_.insert(i, sprite->GetAngle());
+    scaleX_.insert(i, sprite->GetScaleX());
+    scaleY_.insert(i, sprite->GetScaleY());
+    alpha_.insert(i, sprite->GetAlpha());
+
+    QVector<float>::iterator it = std::lower_bound(depths_.begin()
+                                                   , depths_.end(), depth);
+
+    if (it == depths_.end() || *it != depth) depths_.insert(it, depth);
+
+    return true;
+}
+
+void OGAnimationSystem::Update(float dt)
+{
+    dt = qMin(dt, MAX_DT);
+
+    for (int i = 0; i < sprites_.size(); i++)
+    {
+        const OGAnimation* a = animation_.at(i);
+        float phase = phase_.at(i) + dt * speed_.at(i);
+
+        if (phase >= a->count || phase < 0)
+        {
+            phase -= qFloor(phase / a->count) * a->count;
+        }
+
+        phase_[i] = phase;
+
+        int s = qMin(int(phase), a->count - 1);
+        OGSprite* sprite = sprites_.at(i);
+
+        sprite->SetPosition(x_.at(i) + a->x.at(s), y_.at(i) + a->y.at(s));
+        sprite->SetAngle(angle_.at(i) + a->angle.at(s));
+        sprite->SetScaleX(scaleX_.at(i) * a->scaleX.at(s));
+        sprite->SetScaleY(scaleY_.at(i) * a->scaleY.at(s));
+        sprite->SetAlpha(alpha_.at(i) * a->alpha.at(s));
+    }
+}
+
+void OGAnimationSystem::Paint(QPainter* painter, const QRectF &view
+                              , float depth, OGRenderStats* stats)
+{
+    QVector<OGSprite*>::const_iterator it =
+            std::lower_bound(sprites_.constBegin(), sprites_.constEnd(), depth
+                             , SpriteLess);
+
+    for (; it != sprites_.constEnd() && (*it)->GetDepth() == depth; ++it)
+    {
+        OGSprite* sprite = *it;
+
+        if (!sprite->IsVisible()) continue;
+
+        if (!view.intersects(sprite->GetBounds()))
+        {
+            if (stats) stats->culled++;
+            continue;
+        }
+
+        sprite->Paint(painter);
+
+        if (stats) stats->drawn++;
+    }
+}
+
+const OGAnimation* OGAnimationSystem::_GetAnimation(const QString &name)
+{
+    QHash<QString, OGAnimation*>::const_iterator it = animations_.constFind(name);
+
+    // A missing animation is remembered too, it's reported once
+    if (it != animations_.constEnd()) return it.value();
+
+    OGAnimation* animation = OGAnimation::Load("./res/anim/" + name
+                                               + ".anim.binltl");
+    animations_.insert(name, animation);
+
+    return animation;
+}
@@ -0,0 +1,69 @@
+#ifndef OG_ANIMATIONSYSTEM_H
+#define OG_ANIMATIONSYSTEM_H
+
+#include <QHash>
+#include <QRectF>
+#include <QString>
+#include <QVector>
+
+struct OGAnimation;
+struct OGRenderStats;
+class OGSprite;
+class QPainter;
+
+// Plays the animations of the scene layers, on the GUI thread. An animation
+// is loaded and baked once and shared by the sprites which play it, it stays
+// loaded until the system is destroyed, so the menus don't load it again.
+//
+// The played sprites are kept sorted by depth in arrays, one per property,
+// and Update() moves all of them in one pass of table lookups. The sprites
+// are owned by OGWorld; they aren't in the cached scene layers, which would
+// be rebuilt on every frame, and are painted by depth between them.
+class OGAnimationSystem
+{
+    public:
+        OGAnimationSystem();
+        ~OGAnimationSystem();
+
+        // Forgets the sprites, not the animations
+        void Clear();
+
+        // name is of a file in res/anim. The current transform of the sprite
+        // is the base of the animation. Returns false if the animation
+        // can't be loaded, the sprite isn't played then.
+        bool Add(OGSprite* sprite, const QString &name, float speed);
+
+        // dt is in seconds
+        void Update(float dt);
+
+        // Paints the sprites of the depth
+        void Paint(QPainter* painter, const QRectF &view, float depth
+                   , OGRenderStats* stats);
+
+        // The depths of the sprites, sorted
+        const QVector<float>& Depths() const { return depths_; }
+
+        int Count() const { return sprites_.size(); }
+
+    private:
+        QHash<QString, OGAnimation*> animations_;
+        QVector<float> depths_;
+
+        QVector<OGSprite*> sprites_;
+        QVector<const OGAnimation*> animation_;
+        QVector<float> phase_; // in samples
+        QVector<float> speed_;
+        QVector<float> x_;
+        QVector<float> y_;
+        QVector<float> angle_;
+        QVector<float> scaleX_;
+        QVector<float> scaleY_;
+        QVector<float> alpha_;
+
+        OGAnimationSystem(const OGAnimationSystem&);
+        OGAnimationSystem& operator=(const OGAnimationSystem&);
+
+        const OGAnimation* _GetAnimation(const QString &name);
+};
+
+#endif // OG_ANIMATIONSYSTEM_H
@@ -8,16 +8,44 @@
 #include "physics.h"
 #include "og_ibody.h"
 #include "og_world.h"
+#include "og_simulation.h"
 #include "opengoo.h"
 #include "ballsensor.h"
+#include "SoundEngine/og_soundengine.h"
+#include "og_primitivebatch.h"
+#include "og_rendersnapshot.h"
+#include "wog_effects.h"
+#include "logger.h"
 #include <QLineF>
 #include <QPen>
-#include <QPainter>
 
 #include <QtCore/qmath.h>
 
+#include <cfloat>
+
 using namespace og;
 
+namespace
+{
+// Names and voice priorities of the ball events, in the order of BallEvent
+const char* const EVENT_NAMES[] =
+{
+    "attach", "attachcloser", "bounce", "detached", "drop", "exit", "land"
+    , "marker", "pickup", "snap", "suction", "throw"
+};
+
+const int EVENT_PRIORITIES[] =
+{
+    3, 3, 1, 2, 2, 4, 1, 0, 2, 4, 2, 2
+};
+
+// The speed above which a ball hitting geometry bounces instead of landing
+const float BOUNCE_SPEED = 5.0f;
+
+// The drag speed above which a released ball sounds thrown, not dropped
+const float THROW_SPEED = 10.0f;
+}
+
 inline float LengthSquared(float x1, float y1, float x2, float y2);
 inline float LengthSquared(const QPointF* p1, const QPointF* p2);
 
@@ -31,12 +59,13 @@ float LengthSquared(float x1, float y1, float x2, float y2)
     return qPow((x2 - x1), 2.0f) + qPow((y2 - y1), 2.0f);
 }
 
-OGBall::OGBall(WOGBallInstance* data, WOGBall* configuration)
+OGBall::OGBall(WOGBallInstance* data, WOGBall* configuration, OGWorld* world)
     : pData_(data)
     , pConfig_(configuration)
     , pWalkBehavior_(0)
     , pClimbBehavior_(0)
     , pFlyBehavior_(0)
+    , _world(world)
 {
     const float K = 0.1f;
 
@@ -45,6 +74,7 @@ OGBall::OGBall(WOGBallInstance* data, WOGBall* configuration)
     isDetaching_ = false;
     isDragging_ = false;
     isFalling_ = false;
+    isFrozen_ = false;
     isMarked_ = false;
     isStanding_ = false;
     isWalking_ = false;    
@@ -58,10 +88,14 @@ OGBall::OGBall(WOGBallInstance* data, WOGBall* configuration)
     isInit_ = false;
     pTargetBall_ = 0;
     pOriginBall_ = 0;
+    dragPos_.SetZero();
+    dragVelocity_.SetZero();
     isSuction_ = false;
     isExit_ = false;
 
     _isTouching = false;
+    _contacts = 0;
+    _walkableContacts = 0;
 
     WOGBallShape* ballShape = GetShape();
 
@@ -89,9 +123,11 @@ OGBall::OGBall(WOGBallInstance* data, WOGBall* configuration)
 
     if (obj != 0)
     {
-        body = obj->body;
-        fixture = obj->fixture;
-        shape = obj->shape;
+        TakeOver(obj);
+
+        // Lets OGWorld::PickBall() find the ball from a broadphase query
+        for (b2Fixture* f = body->GetFixtureList(); f; f = f->GetNext())
+            f->SetUserData(this);
     }
 
     towerMass_ = pConfig_->attribute.core.towermass * K;
@@ -103,6 +139,9 @@ OGBall::OGBall(WOGBallInstance* data, WOGBall* configuration)
     SetWalkSpeed(pConfig_->attribute.movement.walkspeed);
     SetClimbSpeed(pConfig_->attribute.movement.climbspeed);    
 
+    _LoadSounds();
+    _LoadEffects();
+
     if (pData_->discovered) _isSleeping = false;
     else
     {
@@ -114,6 +153,8 @@ OGBall::OGBall(WOGBallInstance* data, WOGBall* configuration)
 
 OGBall::~OGBall()
 {
+    if (body) delete GetUserData();
+
     delete pWalkBehavior_;
     delete pClimbBehavior_;
     delete pFlyBehavior_;
@@ -126,6 +167,27 @@ QVector2D OGBall::GetCenter() const
     return QVector2D(pos.x, pos.y);
 }
 
+QRectF OGBall::GetBounds() const
+{
+    const float K = 10.0f;
+    const float LABEL_SIZE = 40.0f; // the id is painted to the right
+
+    float posX = GetX() * K;
+    float posY = GetY() * K * (-1.0);
+    float radius = shape->GetRadius() * K;
+
+    QRectF bounds(posX - radius, posY - radius
+                  , radius + qMax(radius, LABEL_SIZE), radius * 2);
+
+    Q_FOREACH(OGBall * ball, jointBalls_)
+    {
+        QPointF pos(ball->GetX() * K, ball->GetY() * K * (-1.0));
+        bounds |= QRectF(pos, QSizeF(1, 1));
+    }
+
+    return bounds;
+}
+
 OGPhysicsBody* OGBall::CreateCircle(float x, float y, float angle
                                     , float mass, WOGBallShape* shape
                                     , int variation)
@@ -135,13 +197,8 @@ OGPhysicsBody* OGBall::CreateCircle(float x, float y, float angle
 
     if (variation >= 1) { radius += radius * (qrand() % variation) * 0.01f; }
 
-    OGUserData* data = new OGUserData;
-    data->type = OGUserData::BALL;
-    data->isTouching = false;
-    data->isAttachedOnEnter = false;
-    data->data = this;
-
-    return createCircle(x, y, radius, angle, &material_, true, mass, data);
+    return createCircle(x, y, radius, angle, &material_, true, mass
+                        , _CreateUserData());
 }
 
 OGPhysicsBody* OGBall::CreateReactangle(float x, float y, float angle
@@ -158,7 +215,19 @@ OGPhysicsBody* OGBall::CreateReactangle(float x, float y, float angle
         h += h * (qrand() % variation) * 0.01f;
     }
 
-    return createRectangle(x, y, w, h, angle, &material_, true, mass, 0);
+    return createRectangle(x, y, w, h, angle, &material_, true, mass
+                           , _CreateUserData());
+}
+
+OGUserData* OGBall::_CreateUserData()
+{
+    OGUserData* data = new OGUserData;
+    data->type = OGUserData::BALL;
+    data->isTouching = false;
+    data->isAttachedOnEnter = false;
+    data->data = this;
+
+    return data;
 }
 
 inline void OGBall::SetBodyPosition(float x, float y)
@@ -180,6 +249,13 @@ void OGBall::Detache()
         joints = joints->next;
     }
 
+    // The strands torn off snap
+    if (!strands.isEmpty())
+    {
+        _PlaySound(DETACHED);
+        _PlaySound(SNAP);
+    }
+
     while (!strands.isEmpty()) { _RemoveStrand(strands.takeFirst()); }
 
     body->SetAwake(false);
@@ -189,6 +265,8 @@ void OGBall::Attache(OGBall* ball) { _CreateStrand(this, ball); }
 
 void OGBall::Attache()
 {
+    if (!jointBalls_.isEmpty()) { _PlaySound(ATTACH); }
+
     while (!jointBalls_.isEmpty()) { Attache(jointBalls_.takeFirst()); }
 }
 
@@ -200,6 +278,8 @@ void OGBall::SetCurrentPosition(const b2Vec2 &pos)
 
 void OGBall::SetExit(bool exit)
 {
+    if (exit && !isExit_) { _PlaySound(EXIT); }
+
     isExit_ = exit;
     body->SetActive(!exit);    
 }
@@ -222,13 +302,25 @@ void OGBall::Update()
         }
     }
 
+    // The structure doesn't move on its own, the contacts are its body's
+    if (isFrozen_) return;
+
     SetCurrentPosition(GetBodyPosition());
 
-    b2ContactEdge* edge = body->GetContactList();
+    // A dragged body is moved by hand and has no velocity of its own. The
+    // update runs once per tick of the simulation.
+    if (isDragging_)
+    {
+        b2Vec2 pos = GetBodyPosition();
+        dragVelocity_ = float(1000.0 / OGSimulation::StepTime()) * (pos - dragPos_);
+        dragPos_ = pos;
+    }
+
+    bool wasFalling = isFalling_;
 
     if (!isClimbing_ && !isDragging_)
     {
-        if (edge == 0)
+        if (_contacts == 0)
         {
             // The ball's falling
 
@@ -236,7 +328,7 @@ void OGBall::Update()
             isStanding_ = false;
             isWalking_ = false;
         }
-        else if (IsOnWalkableGeom(edge))
+        else if (_walkableContacts > 0)
         {
             isFalling_ = false;
 
@@ -272,6 +364,12 @@ void OGBall::Update()
             isStanding_ = true;
             isWalking_ = false;
         }
+
+        if (wasFalling && !isFalling_)
+        {
+            float speed = GetVelocity().length();
+            _PlaySound(speed > BOUNCE_SPEED ? BOUNCE : LAND);
+        }
     }
 
     if ((isClimbing_ || isWalking_) && !isMarked_) { Move(); }
@@ -318,40 +416,23 @@ inline bool OGBall::IsCanClimb()
     else { return false; }
 }
 
-// TODO need a new algorithm
-inline bool OGBall::IsOnWalkableGeom(b2ContactEdge* edge)
+void OGBall::AddContact(bool walkable)
 {
-    OGUserData* data;
-    OGIBody* geom;
-
-    while (edge) // collied with geom
-    {
-        data = static_cast<OGUserData*>(edge->other->GetUserData());
+    _contacts++;
 
-        if (data)
-        {
-            if (data->type == OGUserData::GEOM)
-            {
-                geom = static_cast<OGIBody*>(data->data);
-
-                if (geom->walkable()) { return true; }
-            }
-        }
-
-        edge = edge->next;
-    }
-
-    return false;
+    if (walkable) _walkableContacts++;
 }
 
-void OGBall::Paint(QPainter* painter, bool debug)
+void OGBall::RemoveContact(bool walkable)
 {
-    Q_UNUSED(debug)
+    _contacts--;
 
-    if (isExit()) return;
+    if (walkable) _walkableContacts--;
+}
 
+void OGBall::GetState(OGBallState* state) const
+{
     float posX, posY, radius, angle;
-    QLineF line;
 
     const float K = 10.0f;
     const qreal DEGREE = 57.2957795;
@@ -360,71 +441,73 @@ void OGBall::Paint(QPainter* painter, bool debug)
     posY = GetY() * K * (-1.0);
     radius = shape->GetRadius() * K;
     angle = body->GetAngle() * DEGREE;
-    line.setP1(QPointF(posX, posY));
-    line.setP2(QPointF(posX + radius, posY));
-    line.setAngle(angle);
 
-    QPen pen(Qt::yellow,  2.0);
+    state->position = QPointF(posX, posY);
+    state->direction.setP1(state->position);
+    state->direction.setP2(QPointF(posX + radius, posY));
+    state->direction.setAngle(angle);
+    state->radius = radius;
+    state->ball = this;
+    state->id = id();
+    state->bounds = GetBounds();
 
-    painter->save();
-    painter->setPen(pen);
-    painter->drawLine(line);
+    state->color = Qt::yellow;
 
-    if (isAttached_)
-    {
-        pen.setColor(Qt::blue);
-        painter->setPen(pen);
-    }
-    else if (isClimbing_)
-    {
-        pen.setColor(Qt::red);
-        painter->setPen(pen);
-    }
-    else if (isWalking_)
-    {
-        pen.setColor(Qt::black);
-        painter->setPen(pen);
-    }
-    else if (isFalling_)
-    {
-        pen.setColor(Qt::green);
-        painter->setPen(pen);
-    }
+    if (isAttached_) state->color = Qt::blue;
+    else if (isClimbing_) state->color = Qt::red;
+    else if (isWalking_) state->color = Qt::black;
+    else if (isFalling_) state->color = Qt::green;
 
-    if (isStanding_)
+    if (isStanding_) state->color = Qt::yellow;
+
+    if (isMarked_) state->color = Qt::magenta;
+
+    state->joints.resize(0);
+
+    Q_FOREACH(OGBall * ball, jointBalls_)
     {
-        pen.setColor(Qt::yellow);
-        painter->setPen(pen);
+        state->joints.append(QPointF(ball->GetX() * K
+                                     , ball->GetY() * K * (-1.0)));
     }
 
-    if (isMarked_)
+    state->effects.resize(0);
+
+    if (!_effects.isEmpty())
     {
-        pen.setColor(Qt::magenta);
-        painter->setPen(pen);
+        QString name = _GetStateName();
+
+        Q_FOREACH(const Effect &effect, _effects)
+        {
+            if (!effect.state.contains(name)) continue;
+
+            OGBallEffect e = {effect.effect, effect.overball};
+            state->effects.append(e);
+        }
     }
+}
 
-    painter->drawEllipse(QPointF(posX, posY), radius, radius);
-    pen.setColor(Qt::red);
-    painter->setPen(pen);
-    painter->setFont(QFont("Times", 12, QFont::Bold));
-    painter->drawText(QPointF(posX, posY), QString::number(id()));
+void OGBall::Paint(const OGBallState &state, OGPrimitiveBatch* batch)
+{
+    QPen pen(Qt::yellow,  2.0);
 
-    int x1, y1, x2, y2;
+    batch->AddLine(state.direction.p1(), state.direction.p2(), pen);
 
-    Q_FOREACH(OGBall * ball, jointBalls_)
+    pen.setColor(state.color);
+    batch->AddCircle(state.position, state.radius, pen);
+    batch->AddLabel(state.position, state.id, Qt::red);
+
+    pen.setColor(Qt::red);
+
+    Q_FOREACH(const QPointF &pos, state.joints)
     {
-        x1 = GetX() * K;
-        y1 = GetY() * K * (-1.0);
-        x2 = ball->GetX() * K;
-        y2 = ball->GetY() * K * (-1.0);
-        painter->drawLine(QPointF(x1, y1), QPointF(x2, y2));
+        batch->AddLine(state.position, pos, pen);
     }
-
-    painter->restore();
 }
 
 void OGBall::SetSuction(bool suction)
 {
+    if (suction && !isSuction_) { _PlaySound(SUCTION); }
+
     isSuction_ = suction;
 
     if (suction)
@@ -483,6 +566,7 @@ inline void OGBall::FindJointBalls()
     float minlen = pConfig_->strand->minlen;
     float maxlen1 = pConfig_->strand->maxlen1;
 
+    QList<OGBall*> previous = jointBalls_;
     jointBalls_.clear();
 
     Q_FOREACH(OGBall * ball, _GetWorld()->balls())
@@ -504,6 +588,11 @@ inline void OGBall::FindJointBalls()
     {
         jointBalls_.clear();
     }
+
+    if (!jointBalls_.isEmpty() && jointBalls_ != previous)
+    {
+        _PlaySound(ATTACHCLOSER);
+    }
 }
 
 void OGBall::FindTarget()
@@ -545,6 +634,8 @@ void OGBall::MouseDown(const QPoint &pos)
 
     const float K = 0.1f;
 
+    _PlaySound(PICKUP);
+
     isDragging_ = true;
     isClimbing_ = false;
     isFalling_ = false;
@@ -554,6 +645,9 @@ void OGBall::MouseDown(const QPoint &pos)
     float y = pos.y() * K;
 
     SetBodyPosition(x, y);
+
+    dragPos_ = GetBodyPosition();
+    dragVelocity_.SetZero();
 }
 
 void OGBall::MouseUp(const QPoint &pos)
@@ -564,7 +658,9 @@ void OGBall::MouseUp(const QPoint &pos)
 
     if (!isAttached_)
     {
-        while (!jointBalls_.isEmpty()) { Attache(jointBalls_.takeFirst()); }
+        if (!jointBalls_.isEmpty()) { Attache(); }
+        else if (dragVelocity_.Length() > THROW_SPEED) { _PlaySound(THROW); }
+        else { _PlaySound(DROP); }
     }
 
     isDragging_ = false;
@@ -586,6 +682,8 @@ void OGBall::MouseMove(const QPoint &pos)
 
 void OGBall::SetMarked(bool status)
 {
+    if (status && !isMarked_) { _PlaySound(MARKER); }
+
     isMarked_ = status;
 
     if (isMarked_)
@@ -594,63 +692,58 @@ void OGBall::SetMarked(bool status)
     }
 }
 
-bool OGBall::TestPoint(const QPoint &pos)
+bool OGBall::TestPoint(const QPoint &pos, float radius) const
 {
     const float K = 0.1f;
 
-    float x = pos.x() * K;
-    float y = pos.y() * K;
-
-    return fixture->TestPoint(b2Vec2(x, y));
+    return GetPickDistance(b2Vec2(pos.x() * K, pos.y() * K)) <= radius;
 }
 
-void OGBall::Algorithm2()
+float OGBall::GetPickDistance(const b2Vec2 &point) const
 {
-    if (_GetWorld()->nearestball() == 0) return;
+    if (type_ == OGBall::C_BALL)
+    {
+        return (point - body->GetPosition()).Length() - shape->GetRadius();
+    }
 
-    OGUserData* data;
-    float dist1, dist2;
+    if (fixture->TestPoint(point)) return 0.0f;
 
-    b2JointEdge* joints = 0;
-    joints = pTargetBall_->GetJoints();
-    OGBall* ball = 0;
-    b2Body* b1 = 0;
-    b2Body* b2 = 0;
+    // Other shapes are approximated by their bounding box. It's computed
+    // from the body, the broadphase one is stale while the ball is frozen.
+    b2AABB aabb;
+    fixture->GetShape()->ComputeAABB(&aabb, body->GetTransform(), 0);
+    float dx = qMax(qMax(aabb.lowerBound.x - point.x, point.x - aabb.upperBound.x), 0.0f);
+    float dy = qMax(qMax(aabb.lowerBound.y - point.y, point.y - aabb.upperBound.y), 0.0f);
 
-    b2Vec2 pos(_GetWorld()->nearestball()->GetBodyPosition());
+    return qMax(qSqrt(dx * dx + dy * dy), FLT_EPSILON);
+}
 
-    while (joints)
-    {
-        if (b1 == 0)
-        {
-            b1 = joints->other;
-            dist1 = b2Distance(b1->GetPosition(), pos);
-        }
-        else
-        {
-            b2 = joints->other;
-            dist2 = b2Distance(b2->GetPosition(), pos);
+void OGBall::Algorithm2()
+{
+    OGClimbRoutes* routes = _GetWorld()->climbroutes();
 
-            if (dist2 < dist1)
-            {
-                dist1 = dist2;
-                b1 = b2;
-            }
-        }
+    if (routes->Goal() == 0) return;
 
-        joints = joints->next;
-    }
+    OGBall* ball = routes->NextHop(pTargetBall_);
+
+    // At the goal, or cut off from it, the ball goes back and forth
+    // along its strand
+    if (ball == 0) ball = pOriginBall_;
 
-    if (b1 != 0)
+    if (ball == 0 && pTargetBall_->GetJoints())
     {
-        data = static_cast<OGUserData*>(b1->GetUserData());
-        ball = static_cast<OGBall*>(data->data);
-        pClimbBehavior_->initNewTarget();
-        SetOrigin(pTargetBall_);
-        pOriginBall_=pTargetBall_;
-        SetTarget(ball);
-        pTargetBall_ = ball;
+        b2Body* other = pTargetBall_->GetJoints()->other;
+        ball = static_cast<OGBall*>(OGUserData::GetUserData(
+                                        other->GetUserData())->data);
     }
+
+    if (ball == 0 || ball == pTargetBall_) return;
+
+    pClimbBehavior_->initNewTarget();
+    SetOrigin(pTargetBall_);
+    pOriginBall_ = pTargetBall_;
+    SetTarget(ball);
+    pTargetBall_ = ball;
 }
 
 inline float OGBall::DistanceSquared(OGBall* b1, OGBall* b2) const
@@ -679,11 +772,6 @@ inline float OGBall::Distance(OGBall* b)
     return Distance(b, this);
 }
 
-inline OGWorld* OGBall::_GetWorld()
-{
-    return OpenGOO::instance()->GetWorld();
-}
-
 void OGBall::_RemoveStrand(OGStrand* strand)
 {
     OGWorld* world = _GetWorld();
@@ -775,3 +863,79 @@ std::unique_ptr<BallSensor> OGBall::getSensor()
 {
     return std::unique_ptr<BallSensor>(new BallSensor(this));
 }
+
+void OGBall::_LoadSounds()
+{
+    OGSoundEngine* engine = OGSoundEngine::GetInstance();
+    OGWorld* world = _GetWorld();
+
+    if (!engine->isInitialized() || world->isHeadless()) return;
+
+    Q_FOREACH(const WOGBallSound &sound, pConfig_->sound)
+    {
+        int event = -1;
+
+        for (int i = 0; i < EVENT_COUNT; i++)
+        {
+            if (sound.event == EVENT_NAMES[i])
+            {
+                event = i;
+                break;
+            }
+        }
+
+        if (event == -1) continue;
+
+        Q_FOREACH(const QString &id, sound.id)
+        {
+            unsigned int buffer = engine->LoadSound(world->GetSoundPath(id));
+
+            if (buffer) _sounds[event] << buffer;
+        }
+    }
+}
+
+void OGBall::_LoadEffects()
+{
+    OGWorld* world = _GetWorld();
+
+    if (world->isHeadless() || !world->effectsdata()) return;
+
+    Q_FOREACH(const WOGBallParticles &particles, pConfig_->particles)
+    {
+        const WOGParticleEffect* effect
+            = world->effectsdata()->GetEffect(particles.effect);
+
+        if (!effect)
+        {
+            logWarn("Unknown effect " + particles.effect);
+            continue;
+        }
+
+        Effect e = {effect, particles.state, particles.overball};
+        _effects << e;
+    }
+}
+
+// The state names of balls.xml
+QString OGBall::_GetStateName() const
+{
+    if (_isSleeping) return "sleeping";
+    else if (isDragging_) return "dragging";
+    else if (isClimbing_) return "climbing";
+    else if (isAttached_) return "attached";
+    else if (isWalking_) return "walking";
+    else if (isFalling_) return "falling";
+
+    return "standing";
+}
+
+void OGBall::_PlaySound(BallEvent event)
+{
+    const QList<unsigned int> &sounds = _sounds[event];
+
+    if (sounds.isEmpty()) return;
+
+    unsigned int buffer = sounds.at(qrand() % sounds.size());
+    OGSoundEngine::GetInstance()->Play(buffer, event, EVENT_PRIORITIES[event]);
+}
@@ -52,6 +52,8 @@
 
 #include <OGPhysicsBody>
 #include "wog_material.h"
+#include <QRectF>
+#include <QStringList>
 //#include "og_ibody.h"
 //#include "wog_level.h"
 //#include "wog_ball.h"
@@ -60,6 +62,7 @@ struct WOGLevelExit;
 struct WOGBallInstance;
 struct WOGBall;
 struct WOGBallShape;
+struct WOGParticleEffect;
 
 struct OGUserData;
 
@@ -71,14 +74,15 @@ class OGIFlyBehavior;
 
 class OGWorld;
 
-class QPainter;
+class OGPrimitiveBatch;
+struct OGBallState;
 
 class BallSensor;
 
 class OGBall : public og::OGPhysicsBody
 {
     public:
-        OGBall(WOGBallInstance* data, WOGBall* configuration);
+        OGBall(WOGBallInstance* data, WOGBall* configuration, OGWorld* world);
         virtual ~OGBall();
 
         // Get properties
@@ -88,6 +92,7 @@ class OGBall : public og::OGPhysicsBody
         bool IsClimbing() const { return isClimbing_; }
         bool IsDragging() const { return isDragging_; }
         bool IsFalling() const { return isFalling_; }
+        bool IsFrozen() const { return isFrozen_; }
         bool IsMarked() const { return isMarked_; }
         bool IsStanding() const { return isStanding_; }
         bool IsSuckable() const { return isSuckable_; }
@@ -103,6 +108,9 @@ class OGBall : public og::OGPhysicsBody
         QVector2D GetCenter() const;
         float getRadius() const { return shape->GetRadius(); }
 
+        // Area covered by Paint() in the scene coordinates
+        QRectF GetBounds() const;
+
         QString GetId() const;
         b2JointEdge* GetJoints() { return body->GetJointList(); }
         int GetMaxStrands() const;
@@ -114,6 +122,8 @@ class OGBall : public og::OGPhysicsBody
         void SetDetaching(bool status) { isDetaching_ = status; }
         void SetDragging(bool status) { isDragging_ = status; }
         void SetFalling(bool status) { isFalling_ = status; }
+        // Set by OGStructureFreezer, the body is replaced by the structure's
+        void SetFrozen(bool status) { isFrozen_ = status; }
         void SetMarked(bool status);
         void SetStanding(bool status) { isStanding_ = status; }
         void SetWalking(bool status) { isWalking_ = status; }
@@ -128,10 +138,18 @@ class OGBall : public og::OGPhysicsBody
 
         void Attache(OGBall* ball);
 
-        void Paint(QPainter* painter, bool debug = false);
+        // The ball is painted from its state, which is taken on
+        // the simulation thread
+        void GetState(OGBallState* state) const;
+        static void Paint(const OGBallState &state, OGPrimitiveBatch* batch);
         void Update();
         void Select();
-        bool TestPoint(const QPoint &pos);
+        // radius widens the ball for picking, in physics units
+        bool TestPoint(const QPoint &pos, float radius = 0.0f) const;
+
+        // Distance from the point (in physics units) to the ball,
+        // 0 or less if the point is inside
+        float GetPickDistance(const b2Vec2 &point) const;
 
         void MouseDown(const QPoint &pos);
         void MouseUp(const QPoint &pos);
@@ -141,6 +159,11 @@ class OGBall : public og::OGPhysicsBody
 
         void touching() { _isTouching = true; }
 
+        // Called by OGGroundContacts when a contact of the ball starts
+        // or stops touching, walkable if it's with a walkable geom
+        void AddContact(bool walkable);
+        void RemoveContact(bool walkable);
+
 protected:
         enum BallType {C_BALL, R_BALL}; // C_ - circle R_ - rectangle
 
@@ -148,7 +171,17 @@ protected:
         {
             ATTACH
             , ATTACHCLOSER
+            , BOUNCE
+            , DETACHED
+            , DROP
+            , EXIT
+            , LAND
             , MARKER
+            , PICKUP
+            , SNAP
+            , SUCTION
+            , THROW
+            , EVENT_COUNT
         };
 
         WOGBallInstance* pData_;
@@ -162,6 +195,8 @@ protected:
         OGBall* pTargetBall_;
         OGBall* pOriginBall_;
         QPointF curPos_;
+        b2Vec2 dragPos_; // at the last Update()
+        b2Vec2 dragVelocity_;
         float towerMass_;
         QList<OGBall*> jointBalls_;
 
@@ -175,6 +210,7 @@ protected:
         bool isDraggable_;
         bool isDragging_;
         bool isFalling_;
+        bool isFrozen_;
         bool isMarked_;
         bool isStanding_;
         bool isSuckable_;
@@ -209,13 +245,16 @@ protected:
                                         , float mass, WOGBallShape* shape
                                         , int variation);
 
+        // The body's user data, it makes the body known as this ball
+        // to the contacts and the sensors
+        OGUserData* _CreateUserData();
+
         void AddStrand();
         void ReleaseStrand();
 
         void Move();
 
         bool IsCanClimb();
-        bool IsOnWalkableGeom(b2ContactEdge* edge);
 
         void FindJointBalls();
         void FindTarget();
@@ -243,10 +282,30 @@ protected:
     private:
         bool _isSleeping;
         bool _isTouching;
-        OGWorld* _GetWorld();
+        int _contacts;
+        int _walkableContacts;
+        OGWorld* _world;
+        OGWorld* _GetWorld() { return _world; }
         void _RemoveStrand(OGStrand* strand);
         void _CreateStrand(OGBall* b1, OGBall* b2);
 
         std::unique_ptr<BallSensor> _sensor;
         std::unique_ptr<BallSensor> getSensor();
+
+        // Sound buffers of the each event
+        QList<unsigned int> _sounds[EVENT_COUNT];
+        void _LoadSounds();
+        void _PlaySound(BallEvent event);
+
+        // The particle effects of the each state
+        struct Effect
+        {
+            const WOGParticleEffect* effect;
+            QStringList state;
+            bool overball;
+        };
+
+        QList<Effect> _effects;
+        void _LoadEffects();
+        QString _GetStateName() const;
 };
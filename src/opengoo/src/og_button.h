@@ -5,7 +5,7 @@
 
 #include <QPainter>
 
-class OGButton
+class OGButton : og::Tracked<OGButton, og::MemoryTracker::UI>
 {
     OGSprite* up_;
     OGSprite* over_;
@@ -38,11 +38,16 @@ public:
     void setPosition(const QPointF a_position) { position_ = a_position; }
     void setSize(const QSize& a_size) { size_ = a_size; }
 
-    bool TestPoint(const QPoint& pos)
+    QRectF rect() const
     {
         QRectF rect(QPointF(position().x(), position().y()), size());
         rect.moveCenter(position());
-        return rect.contains(pos);
+        return rect;
+    }
+
+    bool TestPoint(const QPoint& pos) const
+    {
+        return rect().contains(pos);
     }
 
     QString getLevelName()
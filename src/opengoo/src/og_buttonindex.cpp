@@ -0,0 +1,62 @@
+#include "og_buttonindex.h"
+#include "og_button.h"
+
+#include <QtCore/qmath.h>
+
+namespace
+{
+const float CELL_SIZE = 128.0f; // in logical pixels
+
+inline quint64 CellKey(int col, int row)
+{
+    return (quint64(quint32(col)) << 32) | quint32(row);
+}
+
+inline int CellIndex(float pos)
+{
+    return qFloor(pos / CELL_SIZE);
+}
+}
+
+void OGButtonIndex::Add(OGButton* button)
+{
+    int index = buttons_.size();
+    buttons_.append(button);
+
+    QRectF rect = button->rect();
+
+    int col1 = CellIndex(rect.left());
+    int col2 = CellIndex(rect.right());
+    int row1 = CellIndex(rect.top());
+    int row2 = CellIndex(rect.bottom());
+
+    for (int row = row1; row <= row2; row++)
+    {
+        for (int col = col1; col <= col2; col++)
+        {
+            grid_[CellKey(col, row)].append(index);
+        }
+    }
+}
+
+void OGButtonIndex::Clear()
+{
+    buttons_.clear();
+    grid_.clear();
+}
+
+OGButton* OGButtonIndex::Find(const QPoint &pos) const
+{
+    QHash<quint64, QVector<int> >::const_iterator it =
+            grid_.constFind(CellKey(CellIndex(pos.x()), CellIndex(pos.y())));
+
+    if (it == grid_.constEnd()) return 0;
+
+    // The indices of a cell are in the order the buttons were added
+    Q_FOREACH (int i, it.value())
+    {
+        if (buttons_.at(i)->TestPoint(pos)) return buttons_.at(i);
+    }
+
+    return 0;
+}
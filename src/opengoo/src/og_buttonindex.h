@@ -0,0 +1,28 @@
+#ifndef OG_BUTTONINDEX_H
+#define OG_BUTTONINDEX_H
+
+#include <QHash>
+#include <QList>
+#include <QVector>
+
+class OGButton;
+class QPoint;
+
+// Uniform grid over the button rects, so a mouse event only tests
+// the few buttons of one cell. The buttons don't move, the grid is
+// filled as they are added.
+class OGButtonIndex
+{
+public:
+    void Add(OGButton* button);
+    void Clear();
+
+    // Returns the first added button under the point or 0
+    OGButton* Find(const QPoint &pos) const;
+
+private:
+    QList<OGButton*> buttons_;
+    QHash<quint64, QVector<int> > grid_;
+};
+
+#endif // OG_BUTTONINDEX_H
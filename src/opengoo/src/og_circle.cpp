@@ -4,12 +4,12 @@
 #include "wog_material.h"
 #include "og_userdata.h"
 
-#include <QPainter>
+#include "og_primitivebatch.h"
 
 OGCircle::OGCircle(WOGCircle* circle, WOGMaterial* material)
     : OGIBody(circle, material)
 {
-    OGPhysicsBody* obj;
+    OGPhysicsBody* obj = 0;
 
     QPointF position = circle->position;
     float32 radius = circle->radius;
@@ -23,12 +23,10 @@ OGCircle::OGCircle(WOGCircle* circle, WOGMaterial* material)
         obj = createCircle(position, radius, 0, material, false, 0, data);
     }
 
-    body = obj->body;
-    fixture = obj->fixture;
-    shape = obj->shape;
+    if (obj) TakeOver(obj);
 }
 
-void OGCircle::_Draw(QPainter* p)
+void OGCircle::_Draw(OGPrimitiveBatch* batch)
 {
     if (debug_)
     {
@@ -37,11 +35,6 @@ void OGCircle::_Draw(QPainter* p)
         float posX = pos.x * 10;
         float posY = pos.y * 10* -1;
 
-        p->save();
-
-        p->setPen(Qt::yellow);
-        p->drawEllipse(QPointF(posX, posY), r, r);
-
-        p->restore();
+        batch->AddCircle(QPointF(posX, posY), r, QPen(Qt::yellow));
     }
 }
@@ -5,11 +5,11 @@
 
 struct WOGCircle;
 
-class QPainter;
+class OGPrimitiveBatch;
 
 class OGCircle : public OGIBody
 {
-        void _Draw(QPainter* p);
+        void _Draw(OGPrimitiveBatch* batch);
 
     public:
         OGCircle(WOGCircle* circle, WOGMaterial* material);
@@ -0,0 +1,164 @@
+#include "og_climbroutes.h"
+#include "og_ball.h"
+#include "GameEngine/metrics.h"
+
+#include <QElapsedTimer>
+
+#include <functional>
+#include <queue>
+#include <vector>
+
+namespace
+{
+typedef std::pair<float, OGBall*> Entry;
+}
+
+OGClimbRoutes::OGClimbRoutes()
+    : goal_(0)
+    , exitX_(0)
+    , exitY_(0)
+    , hasExit_(false)
+    , isDirty_(false)
+{
+}
+
+void OGClimbRoutes::Clear()
+{
+    edges_.clear();
+    next_.clear();
+    goal_ = 0;
+    hasExit_ = false;
+    isDirty_ = false;
+}
+
+void OGClimbRoutes::SetExit(float x, float y)
+{
+    exitX_ = x;
+    exitY_ = y;
+    hasExit_ = true;
+    isDirty_ = true;
+}
+
+void OGClimbRoutes::AddStrand(OGBall* b1, OGBall* b2)
+{
+    edges_[b1] << b2;
+    edges_[b2] << b1;
+    isDirty_ = true;
+}
+
+void OGClimbRoutes::RemoveStrand(OGBall* b1, OGBall* b2)
+{
+    QHash<OGBall*, QList<OGBall*> >::iterator i = edges_.find(b1);
+
+    if (i == edges_.end()) return;
+
+    i->removeOne(b2);
+
+    if (i->isEmpty()) edges_.erase(i);
+
+    i = edges_.find(b2);
+
+    if (i != edges_.end())
+    {
+        i->removeOne(b1);
+
+        if (i->isEmpty()) edges_.erase(i);
+    }
+
+    isDirty_ = true;
+}
+
+void OGClimbRoutes::UpdateGoal()
+{
+    if (!isDirty_ && _FindGoal() != goal_) isDirty_ = true;
+}
+
+OGBall* OGClimbRoutes::Goal()
+{
+    if (isDirty_) _Build();
+
+    return goal_;
+}
+
+OGBall* OGClimbRoutes::NextHop(OGBall* ball)
+{
+    if (isDirty_) _Build();
+
+    return next_.value(ball);
+}
+
+// Dijkstra from the goal, the next hop of a ball is the one it was reached
+// from. The graph has a few hundred balls at most.
+void OGClimbRoutes::_Build()
+{
+    static Metrics::Histogram* buildTime = Metrics::GetHistogram(
+        "climb.routes_build_us", QVector<qint64>() << 10 << 50 << 100 << 500
+        << 1000 << 5000);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    isDirty_ = false;
+    next_.clear();
+    goal_ = _FindGoal();
+
+    if (!goal_) return;
+
+    QHash<OGBall*, float> distance;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > queue;
+
+    distance.insert(goal_, 0);
+    queue.push(Entry(0, goal_));
+
+    while (!queue.empty())
+    {
+        Entry entry = queue.top();
+        queue.pop();
+
+        OGBall* ball = entry.second;
+
+        if (entry.first > distance.value(ball)) continue; // a stale entry
+
+        b2Vec2 p = ball->GetBodyPosition();
+
+        Q_FOREACH(OGBall * other, edges_.value(ball))
+        {
+            float d = entry.first + b2Distance(p, other->GetBodyPosition());
+            QHash<OGBall*, float>::iterator i = distance.find(other);
+
+            if (i != distance.end() && *i <= d) continue;
+
+            distance.insert(other, d);
+            next_.insert(other, ball);
+            queue.push(Entry(d, other));
+        }
+    }
+
+    buildTime->Record(timer.nsecsElapsed() / 1000);
+}
+
+OGBall* OGClimbRoutes::_FindGoal() const
+{
+    if (!hasExit_) return 0;
+
+    b2Vec2 exit(exitX_, exitY_);
+    OGBall* goal = 0;
+    float length = 0;
+
+    QHashIterator<OGBall*, QList<OGBall*> > i(edges_);
+
+    while (i.hasNext())
+    {
+        i.next();
+
+        float d = b2DistanceSquared(i.key()->GetBodyPosition(), exit);
+
+        if (!goal || d < length)
+        {
+            goal = i.key();
+            length = d;
+        }
+    }
+
+    return goal;
+}
@@ -0,0 +1,56 @@
+#ifndef OG_CLIMBROUTES_H
+#define OG_CLIMBROUTES_H
+
+#include <QHash>
+#include <QList>
+
+class OGBall;
+
+// The strand graph of the level and the next hops of the climbers toward
+// the goal, the attached ball nearest to the exit. The graph is kept up to
+// date by the strands being created and removed; the routes are rebuilt by
+// the first lookup after a change, so a climber sees a new strand on its
+// next step and the lookup itself is a hash lookup.
+//
+// The routes are the shortest paths over the strand lengths at the time of
+// the rebuild. The structure moves a little and the goal is re-checked by
+// UpdateGoal(), which rebuilds the routes only if another ball is nearer.
+class OGClimbRoutes
+{
+    public:
+        OGClimbRoutes();
+
+        void Clear();
+
+        // The exit position, in physics units. Without an exit
+        // there's no goal and no routes.
+        void SetExit(float x, float y);
+
+        void AddStrand(OGBall* b1, OGBall* b2);
+        void RemoveStrand(OGBall* b1, OGBall* b2);
+
+        void UpdateGoal();
+
+        OGBall* Goal();
+
+        // The neighbour of the ball on its way to the goal; 0 for the goal
+        // and for the balls which aren't connected to it
+        OGBall* NextHop(OGBall* ball);
+
+    private:
+        QHash<OGBall*, QList<OGBall*> > edges_;
+        QHash<OGBall*, OGBall*> next_;
+        OGBall* goal_;
+        float exitX_;
+        float exitY_;
+        bool hasExit_;
+        bool isDirty_;
+
+        OGClimbRoutes(const OGClimbRoutes&);
+        OGClimbRoutes& operator=(const OGClimbRoutes&);
+
+        void _Build();
+        OGBall* _FindGoal() const;
+};
+
+#endif // OG_CLIMBROUTES_H
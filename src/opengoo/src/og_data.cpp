@@ -1,5 +1,6 @@
 #include "og_data.h"
 #include "logger.h"
+#include "og_configcache.h"
 
 template<class T, class C> T* OGData::_GetData(const QString &path)
 {
@@ -22,7 +23,15 @@ WOGScene* OGData::GetScene(const QString &path)
 
 WOGResources* OGData::GetResources(const QString &path)
 {
-    return _GetData<WOGResources, OGResourceConfig> (path);
+    WOGResources* data = OGConfigCache::LoadResources(path);
+
+    if (!data)
+    {
+        data = _GetData<WOGResources, OGResourceConfig> (path);
+        OGConfigCache::Store(path, data);
+    }
+
+    return data;
 }
 
 WOGText* OGData::GetText(const QString &path, const QString &lang)
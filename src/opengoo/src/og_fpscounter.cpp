@@ -1,4 +1,6 @@
 #include "og_fpscounter.h"
+#include "og_renderstats.h"
+#include "GameEngine/og_framescheduler.h"
 
 using namespace og::ui;
 
@@ -6,10 +8,15 @@ struct OGFPSCounter::Impl
 {
     FPSCounter counter;
     Label label;
+    int fps;
+    OGRenderStats stats;
+    og::OGFrameTimes times;
 };
 
 OGFPSCounter::OGFPSCounter(const QRect &rect) : _pImpl(new Impl)
 {
+    _pImpl->fps = 0;
+
     connect(&_pImpl->counter, SIGNAL(setFPS(int)), this, SLOT(SetFPS(int)));
 
     int w = rect.width();
@@ -27,7 +34,36 @@ void OGFPSCounter::Reset() { _pImpl->counter.reset(); }
 
 void OGFPSCounter::Update(int dt) { _pImpl->counter.update(dt); }
 
+void OGFPSCounter::SetRenderStats(const OGRenderStats &stats)
+{
+    _pImpl->stats = stats;
+}
+
+void OGFPSCounter::SetFrameTimes(const og::OGFrameTimes &times)
+{
+    _pImpl->times = times;
+}
+
 void OGFPSCounter::SetFPS(int fps)
 {
-    _pImpl->label.setText(QString::number(fps));
+    _pImpl->fps = fps;
+    _UpdateText();
+}
+
+void OGFPSCounter::_UpdateText()
+{
+    const og::OGFrameTimes &t = _pImpl->times;
+
+    _pImpl->label.setText(QString("%1\ndrawn: %2\nculled: %3"
+                                  "\nframe p50/p95/p99: %4/%5/%6 ms"
+                                  "\ninput p50/p95/p99: %7/%8/%9 ms")
+                          .arg(_pImpl->fps)
+                          .arg(_pImpl->stats.drawn)
+                          .arg(_pImpl->stats.culled)
+                          .arg(t.p50, 0, 'f', 1)
+                          .arg(t.p95, 0, 'f', 1)
+                          .arg(t.p99, 0, 'f', 1)
+                          .arg(t.inputP50, 0, 'f', 1)
+                          .arg(t.inputP95, 0, 'f', 1)
+                          .arg(t.inputP99, 0, 'f', 1));
 }
@@ -6,6 +6,13 @@
 #include <OGLabel>
 #include <memory>
 
+struct OGRenderStats;
+
+namespace og
+{
+struct OGFrameTimes;
+}
+
 class OGFPSCounter : public QObject
 {
     Q_OBJECT
@@ -19,10 +26,16 @@ public:
     void Reset();
     void Update(int dt);
 
+    // The stats of the last frame are shown below the fps
+    void SetRenderStats(const OGRenderStats &stats);
+    void SetFrameTimes(const og::OGFrameTimes &times);
+
 private:
     struct Impl;
     std::unique_ptr<Impl> _pImpl;
 
+    void _UpdateText();
+
 private slots:
     void SetFPS(int fps);
 };
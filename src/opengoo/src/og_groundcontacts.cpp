@@ -0,0 +1,73 @@
+#include "og_groundcontacts.h"
+#include "og_ball.h"
+#include "og_ibody.h"
+#include "og_userdata.h"
+
+#include <Box2D/Box2D.h>
+
+namespace
+{
+inline OGUserData* GetUserData(b2Fixture* fixture)
+{
+    return OGUserData::GetUserData(fixture->GetBody()->GetUserData());
+}
+
+inline OGBall* GetBall(OGUserData* data)
+{
+    if (!data || data->type != OGUserData::BALL) return 0;
+
+    return static_cast<OGBall*>(data->data);
+}
+
+inline bool IsWalkable(OGUserData* data)
+{
+    return data && data->type == OGUserData::GEOM
+           && static_cast<OGIBody*>(data->data)->walkable();
+}
+}
+
+void OGGroundContacts::Clear()
+{
+    contacts_.clear();
+}
+
+void OGGroundContacts::BeginContact(b2Contact* contact)
+{
+    b2Fixture* fixtureA = contact->GetFixtureA();
+    b2Fixture* fixtureB = contact->GetFixtureB();
+
+    if (fixtureA->IsSensor() || fixtureB->IsSensor()) return;
+
+    OGUserData* dataA = GetUserData(fixtureA);
+    OGUserData* dataB = GetUserData(fixtureB);
+
+    Entry entry;
+    entry.ball[0] = GetBall(dataA);
+    entry.ball[1] = GetBall(dataB);
+
+    if (!entry.ball[0] && !entry.ball[1]) return;
+
+    entry.walkable[0] = IsWalkable(dataB);
+    entry.walkable[1] = IsWalkable(dataA);
+
+    for (int i = 0; i < 2; i++)
+    {
+        if (entry.ball[i]) entry.ball[i]->AddContact(entry.walkable[i]);
+    }
+
+    contacts_.insert(contact, entry);
+}
+
+void OGGroundContacts::EndContact(b2Contact* contact)
+{
+    QHash<b2Contact*, Entry>::iterator it = contacts_.find(contact);
+
+    if (it == contacts_.end()) return;
+
+    for (int i = 0; i < 2; i++)
+    {
+        if (it->ball[i]) it->ball[i]->RemoveContact(it->walkable[i]);
+    }
+
+    contacts_.erase(it);
+}
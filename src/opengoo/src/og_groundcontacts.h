@@ -0,0 +1,38 @@
+#ifndef OG_GROUNDCONTACTS_H
+#define OG_GROUNDCONTACTS_H
+
+#include <OGContactObserver>
+
+#include <QHash>
+
+class OGBall;
+
+// Counts the touching contacts of the balls as they begin and end, so the
+// balls know whether they stand on something walkable without walking their
+// contact lists. A contact is classified when it begins; its end doesn't
+// look at the user data, which may already be deleted with its owner.
+class OGGroundContacts : public og::OGContactObserver
+{
+    public:
+        OGGroundContacts() {}
+
+        // Forgets the contacts, before the balls of the level are deleted
+        void Clear();
+
+        void BeginContact(b2Contact* contact);
+        void EndContact(b2Contact* contact);
+
+    private:
+        struct Entry
+        {
+            OGBall* ball[2];
+            bool walkable[2]; // the other side is a walkable geom
+        };
+
+        QHash<b2Contact*, Entry> contacts_;
+
+        OGGroundContacts(const OGGroundContacts&);
+        OGGroundContacts& operator=(const OGGroundContacts&);
+};
+
+#endif // OG_GROUNDCONTACTS_H
@@ -1,6 +1,7 @@
 #include "og_ibody.h"
 #include "wog_pobject.h"
 #include "wog_material.h"
+#include "og_userdata.h"
 
 #include <QStringList>
 
@@ -16,3 +17,24 @@ OGIBody::OGIBody(WOGPObject* data, WOGMaterial* material)
         if (tag == "walkable") { walkable_ = true; }
     }
 }
+
+OGIBody::~OGIBody()
+{
+    if (body) delete OGUserData::GetUserData(body->GetUserData());
+}
+
+const QRectF& OGIBody::GetBounds() const
+{
+    if (bounds_.isNull() && fixture)
+    {
+        const float K = 10.0f;
+        const float MARGIN = 2.0f; // a line has no width
+
+        const b2AABB &aabb = fixture->GetAABB(0);
+        bounds_ = QRectF(QPointF(aabb.lowerBound.x * K, -aabb.upperBound.y * K)
+                         , QPointF(aabb.upperBound.x * K, -aabb.lowerBound.y * K))
+                .adjusted(-MARGIN, -MARGIN, MARGIN, MARGIN);
+    }
+
+    return bounds_;
+}
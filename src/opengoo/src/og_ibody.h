@@ -2,11 +2,12 @@
 #define OG_IBODY_H
 
 #include <OGPhysicsBody>
+#include <QRectF>
 
 struct WOGMaterial;
 struct WOGPObject;
 
-class QPainter;
+class OGPrimitiveBatch;
 
 class OGIBody : public og::OGPhysicsBody
 {
@@ -15,7 +16,9 @@ class OGIBody : public og::OGPhysicsBody
 
     bool walkable_;    
 
-    virtual void _Draw(QPainter* p) { Q_UNUSED(p) }
+    mutable QRectF bounds_;
+
+    virtual void _Draw(OGPrimitiveBatch* batch) { Q_UNUSED(batch) }
 
 protected:
     // S_ - static D - dynamic
@@ -37,13 +40,17 @@ protected:
 
 public:
     OGIBody(WOGPObject* data, WOGMaterial* material);
-    virtual ~OGIBody() {}       
+    virtual ~OGIBody();
 
     bool walkable() const { return walkable_; }
 
     void SetDebug(bool debug) { debug_ = debug; }
 
-    void Draw(QPainter* p) { _Draw(p); }
+    void Draw(OGPrimitiveBatch* batch) { _Draw(batch); }
+
+    // Bounding box in the scene coordinates. The body is static,
+    // so it's calculated only once.
+    const QRectF& GetBounds() const;
 };
 
 #endif // OG_IBODY_H
@@ -1,20 +1,38 @@
 #include "og_layer.h"
 #include "og_sprite.h"
+#include "og_renderstats.h"
 
 #include <QPainter>
+#include <QtCore/qmath.h>
+#include <algorithm>
 
-OGLayer::OGLayer()
+namespace
+{
+const float CELL_SIZE = 256.0f; // in world units
+
+inline quint64 CellKey(int col, int row)
+{
+    return (quint64(quint32(col)) << 32) | quint32(row);
+}
+
+inline int CellIndex(float pos)
+{
+    return qFloor(pos / CELL_SIZE);
+}
+}
+
+OGLayer::OGLayer() : gridValid_(false)
 {
 }
 
 OGLayer::~OGLayer()
 {
-//    while(!spriteList_.isEmpty()) delete spriteList_.takeFirst();
 }
 
 void OGLayer::Add(OGSprite *sprite)
 {
     spriteList_.append(sprite);
+    gridValid_ = false;
 }
 
 void OGLayer::Paint(QPainter* painter)
@@ -24,3 +42,115 @@ void OGLayer::Paint(QPainter* painter)
         s->Paint(painter);
     }
 }
+
+void OGLayer::Paint(QPainter* painter, const QRectF &rect
+                    , OGRenderStats* stats)
+{
+    _FindVisible(rect);
+
+    Q_FOREACH (int i, visible_)
+    {
+        spriteList_.at(i)->Paint(painter);
+    }
+
+    _Count(stats);
+}
+
+void OGLayer::Cull(const QRectF &rect, OGRenderStats* stats)
+{
+    if (!stats) return;
+
+    _FindVisible(rect);
+    _Count(stats);
+}
+
+void OGLayer::_FindVisible(const QRectF &rect)
+{
+    if (!gridValid_) _BuildGrid();
+
+    visible_.clear();
+
+    int col1 = CellIndex(rect.left());
+    int col2 = CellIndex(rect.right());
+    int row1 = CellIndex(rect.top());
+    int row2 = CellIndex(rect.bottom());
+
+    for (int row = row1; row <= row2; row++)
+    {
+        for (int col = col1; col <= col2; col++)
+        {
+            QHash<quint64, QVector<int> >::const_iterator it =
+                    grid_.constFind(CellKey(col, row));
+
+            if (it == grid_.constEnd()) continue;
+
+            Q_FOREACH (int i, it.value())
+            {
+                if (spriteList_.at(i)->GetBounds().intersects(rect))
+                    visible_.append(i);
+            }
+        }
+    }
+
+    // A sprite may be in several cells, and the sprites must be painted
+    // in the order they were added
+    std::sort(visible_.begin(), visible_.end());
+    visible_.erase(std::unique(visible_.begin(), visible_.end())
+                   , visible_.end());
+}
+
+void OGLayer::_Count(OGRenderStats* stats) const
+{
+    if (stats)
+    {
+        stats->drawn += visible_.size();
+        stats->culled += spriteList_.size() - visible_.size();
+    }
+}
+
+bool OGLayer::TakeDirty()
+{
+    bool dirty = false;
+
+    Q_FOREACH (OGSprite* s, spriteList_)
+    {
+        if (s->IsDirty())
+        {
+            s->ClearDirty();
+            dirty = true;
+        }
+    }
+
+    if (dirty) gridValid_ = false;
+
+    return dirty;
+}
+
+void OGLayer::_BuildGrid()
+{
+    grid_.clear();
+
+    for (int i = 0; i < spriteList_.size(); i++)
+    {
+        OGSprite* s = spriteList_.at(i);
+
+        if (!s->IsVisible()) continue;
+
+        const QRectF &bounds = s->GetBounds();
+
+        int col1 = CellIndex(bounds.left());
+        int col2 = CellIndex(bounds.right());
+        int row1 = CellIndex(bounds.top());
+        int row2 = CellIndex(bounds.bottom());
+
+        for (int row = row1; row <= row2; row++)
+        {
+            for (int col = col1; col <= col2; col++)
+            {
+                grid_[CellKey(col, row)].append(i);
+            }
+        }
+    }
+
+    gridValid_ = true;
+}
@@ -1,15 +1,20 @@
 #ifndef OG_LAYER_H
 #define OG_LAYER_H
 
+#include <QHash>
 #include <QList>
+#include <QVector>
 
 struct OGSprite;
+struct OGRenderStats;
 
 typedef QList<OGSprite*> OGSpriteList;
 
 
 class QPainter;
+class QRectF;
 
+// The sprites are owned by OGWorld, a layer only refers to them
 class OGLayer
 {
 public:
@@ -19,8 +24,30 @@ public:
     void Add(OGSprite* sprite);
     void Paint(QPainter* painter);
 
+    // Paints only the sprites which intersect the rect (in world
+    // coordinates). The sprites are looked up in a uniform grid which is
+    // rebuilt after Add() or after TakeDirty() has found a changed sprite.
+    void Paint(QPainter* painter, const QRectF &rect
+               , OGRenderStats* stats = 0);
+
+    // Counts the sprites which intersect the rect in the stats, without
+    // painting them; for a layer painted from a cache
+    void Cull(const QRectF &rect, OGRenderStats* stats);
+
+    // Returns true if any sprite of the layer has changed since
+    // the last call and clears the dirty flags.
+    bool TakeDirty();
+
 private:
     OGSpriteList spriteList_;
+
+    QHash<quint64, QVector<int> > grid_;
+    QVector<int> visible_;
+    bool gridValid_;
+
+    void _BuildGrid();
+    void _FindVisible(const QRectF &rect);
+    void _Count(OGRenderStats* stats) const;
 };
 
 #endif // OG_LAYER_H
@@ -0,0 +1,107 @@
+#include "og_levelvalidator.h"
+#include "og_world.h"
+#include "og_ball.h"
+#include "og_simulation.h"
+#include "wog_scene.h"
+#include "logger.h"
+
+#include <QDir>
+#include <QRunnable>
+#include <QThreadPool>
+
+#include <atomic>
+
+class OGLevelValidator::Task : public QRunnable
+{
+    public:
+        Task(const QString &level, int steps, std::atomic<int>* failed)
+            : level_(level), steps_(steps), pFailed_(failed)
+        {
+        }
+
+        void run();
+
+    private:
+        QString level_;
+        int steps_;
+        std::atomic<int>* pFailed_;
+
+        static bool _IsInScene(const OGWorld &world);
+};
+
+void OGLevelValidator::Task::run()
+{
+    OGWorld world;
+
+    if (!world.Initialize() || !world.LoadPhysics(level_))
+    {
+        logWarnf("Level \"%1\" doesn't load", level_);
+        (*pFailed_)++;
+
+        return;
+    }
+
+    for (int i = 0; i < steps_; i++)
+    {
+        world.Step(1);
+
+        if (!_IsInScene(world))
+        {
+            logWarnf("Level \"%1\": a ball left the scene after %2 steps"
+                     , level_, i + 1);
+            (*pFailed_)++;
+            world.CloseLevel();
+
+            return;
+        }
+    }
+
+    logInfof("Level \"%1\" is fine", level_);
+    world.CloseLevel();
+}
+
+bool OGLevelValidator::Task::_IsInScene(const OGWorld &world)
+{
+    const WOGScene* scene = world.scenedata();
+    QRectF bounds(scene->minx, scene->miny
+                  , scene->maxx - scene->minx, scene->maxy - scene->miny);
+
+    Q_FOREACH(const OGBall * ball, world.balls())
+    {
+        if (ball->isExit()) continue;
+
+        QPointF center = (ball->GetCenter() * 10.0f).toPointF();
+
+        if (!bounds.contains(center)) return false;
+    }
+
+    return true;
+}
+
+int OGLevelValidator::Run(const QStringList &levels, int seconds)
+{
+    int steps = qRound(seconds * 1000 / OGSimulation::StepTime());
+    std::atomic<int> failed(0);
+    QThreadPool* pool = QThreadPool::globalInstance();
+
+    logInfof("Validating %1 levels on %2 threads", levels.size()
+             , pool->maxThreadCount());
+
+    Q_FOREACH(const QString &level, levels)
+    {
+        pool->start(new Task(level, steps, &failed));
+    }
+
+    pool->waitForDone();
+
+    logInfof("%1 of %2 levels failed", int(failed), levels.size());
+
+    return failed;
+}
+
+QStringList OGLevelValidator::Levels()
+{
+    QDir dir("./res/levels");
+
+    return dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name);
+}
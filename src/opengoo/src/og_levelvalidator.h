@@ -0,0 +1,23 @@
+#ifndef OG_LEVELVALIDATOR_H
+#define OG_LEVELVALIDATOR_H
+
+#include <QStringList>
+
+// Checks the levels in batch: each level is loaded headless with
+// OGWorld::LoadPhysics() and simulated for a while. The levels are run on
+// the global thread pool, one world per thread. A level fails if it doesn't
+// load or one of its balls leaves the scene.
+class OGLevelValidator
+{
+    public:
+        // Returns the number of the levels which failed
+        static int Run(const QStringList &levels, int seconds);
+
+        // The names of the levels in ./res/levels
+        static QStringList Levels();
+
+    private:
+        class Task;
+};
+
+#endif // OG_LEVELVALIDATOR_H
@@ -2,10 +2,10 @@
 #include "physics.h"
 #include "og_userdata.h"
 
-OGLine::OGLine(WOGLine *line, WOGMaterial* material)
+OGLine::OGLine(WOGLine *line, WOGMaterial* material, const WOGScene* scene)
     : OGIBody(line, material)
 {
-    OGPhysicsBody* obj;
+    OGPhysicsBody* obj = 0;
 
     QPointF anchor = line->anchor;
     QPointF normal = line->normal;
@@ -15,10 +15,8 @@ OGLine::OGLine(WOGLine *line, WOGMaterial* material)
         OGUserData* data = new OGUserData;
         data->type = OGUserData::GEOM;
         data->data = this;
-        obj = createLine(anchor, normal, material, false, data);
+        obj = createLine(scene, anchor, normal, material, false, data);
     }
 
-    body = obj->body;
-    fixture = obj->fixture;
-    shape = obj->shape;
+    if (obj) TakeOver(obj);
 }
@@ -7,7 +7,7 @@
 class OGLine : public OGIBody
 {
 public:
-    OGLine(WOGLine* line, WOGMaterial* material);
+    OGLine(WOGLine* line, WOGMaterial* material, const WOGScene* scene);
     virtual ~OGLine() {}
 };
 
@@ -0,0 +1,537 @@
+#include "og_particlesystem.h"
+#include "og_rendersnapshot.h"
+#include "og_renderstats.h"
+#include "spritefactory.h"
+#include "wog_effects.h"
+
+#include <QtCore/qmath.h>
+
+#include <cfloat>
+
+namespace
+{
+const float FRAME_RATE = 60.0f; // fx.xml counts its speeds per frame
+const float MAX_DT = 0.1f;      // a stall doesn't throw the particles away
+const int MAX_PARTICLES = 4096; // per pool
+const int DEFAULT_PARTICLES = 64; // of an endless effect without a maximum
+const int MAX_PRETICK = 600;    // frames
+
+inline float Random(float min, float max)
+{
+    return min + (max - min) * (qrand() / float(RAND_MAX));
+}
+
+inline float Random(const QPointF &range)
+{
+    return Random(range.x(), range.y());
+}
+
+inline float DegreesToRadians(float degrees)
+{
+    return degrees * float(M_PI) / 180.0f;
+}
+}
+
+struct OGParticleSystem::Pool
+{
+    const WOGEffectParticle* config;
+    QVector<ImageSourcePtr> images;
+    float extent; // the largest half diagonal of a particle
+    int capacity;
+    int count;
+
+    QVector<float> x;
+    QVector<float> y;
+    QVector<float> vx;
+    QVector<float> vy;
+    QVector<float> age;
+    QVector<float> life;
+    QVector<float> scale;
+    QVector<float> angle;
+    QVector<float> spin;
+    QVector<quint8> image;
+};
+
+struct OGParticleSystem::Emitter
+{
+    const WOGParticleEffect* effect;
+    const void* ball; // 0 for the emitters of the scene
+    QPointF pos;
+    QRectF bounds;    // of the emitter and its particles
+    QVector<Pool*> pools;
+    float spawn;      // the part of a particle left from the last frame
+    bool isActive;
+    bool isFilled;
+    bool overball;
+
+    ~Emitter()
+    {
+        while (!pools.isEmpty()) { delete pools.last(); pools.removeLast(); }
+    }
+};
+
+OGParticleSystem::OGParticleSystem()
+    : resources_(0)
+{
+}
+
+OGParticleSystem::~OGParticleSystem()
+{
+    Clear();
+}
+
+void OGParticleSystem::Clear()
+{
+    while (!emitters_.isEmpty()) { delete emitters_.takeFirst(); }
+
+    ballEmitters_.clear();
+}
+
+void OGParticleSystem::AddEmitter(const WOGParticleEffect* effect
+                                  , const QPointF &pos, float pretick)
+{
+    Emitter* emitter = _CreateEmitter(effect, pos);
+
+    if (effect->type == WOGParticleEffect::POINT)
+    {
+        int frames = qMin(qRound(pretick), MAX_PRETICK);
+
+        for (int i = 0; i < frames; i++)
+            _Simulate(emitter, 1.0f / FRAME_RATE);
+    }
+
+    emitters_ << emitter;
+}
+
+void OGParticleSystem::UpdateBalls(const QVector<OGBallState> &balls)
+{
+    Q_FOREACH(Emitter * emitter, ballEmitters_)
+    {
+        emitter->isActive = false;
+    }
+
+    for (int i = 0; i < balls.size(); i++)
+    {
+        const OGBallState &ball = balls.at(i);
+
+        for (int j = 0; j < ball.effects.size(); j++)
+        {
+            const OGBallEffect &effect = ball.effects.at(j);
+            BallKey key(ball.ball, effect.effect);
+            Emitter* emitter = ballEmitters_.value(key);
+
+            if (!emitter)
+            {
+                emitter = _CreateEmitter(effect.effect, ball.position);
+                emitter->ball = ball.ball;
+                emitter->overball = effect.overball;
+                ballEmitters_.insert(key, emitter);
+                emitters_ << emitter;
+            }
+
+            emitter->pos = ball.position;
+            emitter->isActive = true;
+        }
+    }
+}
+
+void OGParticleSystem::Update(float dt, const QRectF &view)
+{
+    dt = qMin(dt, MAX_DT);
+
+    for (int i = emitters_.size() - 1; i >= 0; i--)
+    {
+        Emitter* emitter = emitters_.at(i);
+
+        if (emitter->effect->type == WOGParticleEffect::AMBIENT)
+        {
+            if (!emitter->isFilled) _Fill(emitter, view);
+
+            Q_FOREACH(Pool * pool, emitter->pools)
+            {
+                _Move(pool, dt);
+            }
+
+            _Wrap(emitter, view);
+            continue;
+        }
+
+        if (!emitter->isActive && emitter->bounds.isNull())
+        {
+            // The ball has gone and so have its particles
+            ballEmitters_.remove(BallKey(emitter->ball, emitter->effect));
+            emitters_.removeAt(i);
+            delete emitter;
+            continue;
+        }
+
+        // A ball emitter moves with the ball
+        if (emitter->isActive && !view.intersects(emitter->bounds)
+                && !view.contains(emitter->pos))
+        {
+            continue;
+        }
+
+        _Simulate(emitter, dt);
+    }
+}
+
+void OGParticleSystem::Paint(QPainter* painter, const QRectF &view
+                             , bool overball, OGRenderStats* stats)
+{
+    float zoom = qAbs(painter->combinedTransform().m11());
+
+    Q_FOREACH(Emitter * emitter, emitters_)
+    {
+        if (emitter->overball != overball) continue;
+
+        if (emitter->effect->type == WOGParticleEffect::POINT
+                && !view.intersects(emitter->bounds))
+        {
+            stats->culled++;
+            continue;
+        }
+
+        Q_FOREACH(Pool * pool, emitter->pools)
+        {
+            _Paint(painter, pool, zoom);
+        }
+
+        stats->drawn++;
+    }
+}
+
+int OGParticleSystem::Count() const
+{
+    int count = 0;
+
+    Q_FOREACH(const Emitter * emitter, emitters_)
+    {
+        Q_FOREACH(const Pool * pool, emitter->pools)
+        {
+            count += pool->count;
+        }
+    }
+
+    return count;
+}
+
+OGParticleSystem::Emitter* OGParticleSystem::_CreateEmitter(
+    const WOGParticleEffect* effect, const QPointF &pos)
+{
+    Emitter* emitter = new Emitter;
+    emitter->effect = effect;
+    emitter->ball = 0;
+    emitter->pos = pos;
+    emitter->spawn = 0;
+    emitter->isActive = true;
+    emitter->isFilled = false;
+    emitter->overball = false;
+
+    SpriteFactory factory(resources_);
+
+    for (int i = 0; i < effect->particle.size(); i++)
+    {
+        const WOGEffectParticle &config = effect->particle.at(i);
+        Pool* pool = new Pool;
+        pool->config = &config;
+        pool->extent = 0;
+        pool->count = 0;
+        pool->capacity = _Capacity(effect, config);
+
+        float scale = qMax(float(qMax(config.scale.x(), config.scale.y()))
+                           , config.finalscale);
+
+        Q_FOREACH(const QString &id, config.image)
+        {
+            ImageSourcePtr image = factory.CreateImageSource(id);
+
+            if (!image || image->GetWidth() == 0) continue;
+
+            float w = image->GetWidth();
+            float h = image->GetHeight();
+            pool->extent = qMax(pool->extent
+                                , float(0.5f * scale * qSqrt(w * w + h * h)));
+            pool->images << image;
+        }
+
+        if (pool->images.isEmpty())
+        {
+            delete pool;
+            continue;
+        }
+
+        // The whole pool is allocated up front
+        pool->x.resize(pool->capacity);
+        pool->y.resize(pool->capacity);
+        pool->vx.resize(pool->capacity);
+        pool->vy.resize(pool->capacity);
+        pool->age.resize(pool->capacity);
+        pool->life.resize(pool->capacity);
+        pool->scale.resize(pool->capacity);
+        pool->angle.resize(pool->capacity);
+        pool->spin.resize(pool->capacity);
+        pool->image.resize(pool->capacity);
+
+        emitter->pools << pool;
+    }
+
+    return emitter;
+}
+
+void OGParticleSystem::_Simulate(Emitter* emitter, float dt)
+{
+    if (emitter->isActive)
+    {
+        emitter->spawn += emitter->effect->rate * FRAME_RATE * dt;
+
+        int n = int(emitter->spawn);
+        emitter->spawn -= n;
+
+        float x = emitter->pos.x();
+        float y = emitter->pos.y();
+
+        Q_FOREACH(Pool * pool, emitter->pools)
+        {
+            for (int i = 0; i < n && pool->count < pool->capacity; i++)
+                _Spawn(pool, x, y);
+        }
+    }
+
+    QRectF bounds;
+
+    Q_FOREACH(Pool * pool, emitter->pools)
+    {
+        _Move(pool, dt);
+        _Kill(pool);
+        bounds |= _Bounds(pool);
+    }
+
+    // A ball emitter which stopped is culled by its particles only
+    if (emitter->isActive)
+        bounds |= QRectF(emitter->pos, QSizeF(1, 1));
+
+    emitter->bounds = bounds;
+}
+
+// The ambient particles are scattered over the camera and its margin
+void OGParticleSystem::_Fill(Emitter* emitter, const QRectF &view)
+{
+    float m = emitter->effect->margin;
+    QRectF rect = view.adjusted(-m, -m, m, m);
+
+    Q_FOREACH(Pool * pool, emitter->pools)
+    {
+        while (pool->count < pool->capacity)
+        {
+            _Spawn(pool, Random(rect.left(), rect.right())
+                   , Random(rect.top(), rect.bottom()));
+        }
+    }
+
+    emitter->isFilled = true;
+}
+
+void OGParticleSystem::_Wrap(Emitter* emitter, const QRectF &view)
+{
+    float m = emitter->effect->margin;
+    QRectF rect = view.adjusted(-m, -m, m, m);
+
+    const float left = rect.left();
+    const float right = rect.right();
+    const float top = rect.top();
+    const float bottom = rect.bottom();
+    const float w = rect.width();
+    const float h = rect.height();
+
+    Q_FOREACH(Pool * pool, emitter->pools)
+    {
+        float* x = pool->x.data();
+        float* y = pool->y.data();
+        const int n = pool->count;
+
+        for (int i = 0; i < n; i++)
+        {
+            x[i] = x[i] < left ? x[i] + w : (x[i] > right ? x[i] - w : x[i]);
+            y[i] = y[i] < top ? y[i] + h : (y[i] > bottom ? y[i] - h : y[i]);
+        }
+    }
+}
+
+void OGParticleSystem::_Paint(QPainter* painter, Pool* pool, float zoom)
+{
+    if (pool->count == 0) return;
+
+    const WOGEffectParticle* config = pool->config;
+    const bool isScaled = config->finalscale >= 0;
+    const float finalscale = config->finalscale;
+
+    painter->save();
+
+    if (config->additive)
+        painter->setCompositionMode(QPainter::CompositionMode_Plus);
+
+    for (int img = 0; img < pool->images.size(); img++)
+    {
+        float scale = qMax(float(config->scale.y()), finalscale);
+        qreal k;
+        const QPixmap &pixmap = pool->images.at(img)->GetPixmap(zoom * scale, &k);
+        QRectF source(0, 0, pixmap.width(), pixmap.height());
+
+        fragments_.resize(0);
+
+        for (int i = 0; i < pool->count; i++)
+        {
+            if (pool->image.at(i) != img) continue;
+
+            float t = pool->age.at(i) / pool->life.at(i);
+            float s = pool->scale.at(i);
+
+            if (isScaled) s += (finalscale - s) * t;
+
+            float angle = pool->angle.at(i);
+
+            if (config->directed)
+            {
+                angle += qAtan2(pool->vy.at(i), pool->vx.at(i))
+                         * 180.0f / float(M_PI);
+            }
+
+            fragments_ << QPainter::PixmapFragment::create(
+                              QPointF(pool->x.at(i), pool->y.at(i)), source
+                              , s / k, s / k, angle
+                              , config->fade ? 1.0f - t : 1.0f);
+        }
+
+        if (!fragments_.isEmpty())
+        {
+            painter->drawPixmapFragments(fragments_.constData()
+                                         , fragments_.size(), pixmap);
+        }
+    }
+
+    painter->restore();
+}
+
+int OGParticleSystem::_Capacity(const WOGParticleEffect* effect
+                                , const WOGEffectParticle &particle)
+{
+    int capacity = effect->maxparticles;
+
+    // Enough for the rate and the longest life, the particles which live
+    // forever would never fit
+    if (capacity <= 0 && particle.lifespan.y() <= 0)
+        capacity = DEFAULT_PARTICLES;
+    else if (capacity <= 0)
+        capacity = qCeil(effect->rate * FRAME_RATE * particle.lifespan.y()) + 1;
+
+    return qBound(1, capacity, MAX_PARTICLES);
+}
+
+void OGParticleSystem::_Spawn(Pool* pool, float x, float y)
+{
+    const WOGEffectParticle* config = pool->config;
+    int i = pool->count++;
+
+    float speed = Random(config->speed) * FRAME_RATE;
+    float dir = DegreesToRadians(config->movedir
+                                 + Random(-config->movedirvar
+                                          , config->movedirvar));
+    float life = Random(config->lifespan);
+
+    // The scene is painted with y down, fx.xml has y up
+    pool->x[i] = x;
+    pool->y[i] = y;
+    pool->vx[i] = qCos(dir) * speed;
+    pool->vy[i] = -qSin(dir) * speed;
+    pool->age[i] = 0;
+    pool->life[i] = life > 0 ? life : FLT_MAX;
+    pool->scale[i] = Random(config->scale);
+    pool->angle[i] = Random(config->rotation);
+    pool->spin[i] = Random(config->rotspeed) * FRAME_RATE * 180.0f / float(M_PI);
+    pool->image[i] = quint8(qrand() % pool->images.size());
+}
+
+void OGParticleSystem::_Move(Pool* pool, float dt)
+{
+    const WOGEffectParticle* config = pool->config;
+    const float damping = qPow(1.0f - config->dampening, dt * FRAME_RATE);
+    const float ax = config->acceleration.x() * FRAME_RATE * FRAME_RATE * dt;
+    const float ay = -config->acceleration.y() * FRAME_RATE * FRAME_RATE * dt;
+
+    // The arrays of a pool never overlap
+    float* __restrict x = pool->x.data();
+    float* __restrict y = pool->y.data();
+    float* __restrict vx = pool->vx.data();
+    float* __restrict vy = pool->vy.data();
+    float* __restrict age = pool->age.data();
+    float* __restrict angle = pool->angle.data();
+    const float* __restrict spin = pool->spin.constData();
+    const int n = pool->count;
+
+    // No branches and no aliasing, the loops can be vectorized
+    for (int i = 0; i < n; i++)
+    {
+        vx[i] = vx[i] * damping + ax;
+        vy[i] = vy[i] * damping + ay;
+    }
+
+    for (int i = 0; i < n; i++)
+    {
+        x[i] += vx[i] * dt;
+        y[i] += vy[i] * dt;
+        angle[i] += spin[i] * dt;
+        age[i] += dt;
+    }
+}
+
+void OGParticleSystem::_Kill(Pool* pool)
+{
+    int i = 0;
+
+    while (i < pool->count)
+    {
+        if (pool->age.at(i) < pool->life.at(i))
+        {
+            i++;
+            continue;
+        }
+
+        int last = --pool->count;
+
+        pool->x[i] = pool->x.at(last);
+        pool->y[i] = pool->y.at(last);
+        pool->vx[i] = pool->vx.at(last);
+        pool->vy[i] = pool->vy.at(last);
+        pool->age[i] = pool->age.at(last);
+        pool->life[i] = pool->life.at(last);
+        pool->scale[i] = pool->scale.at(last);
+        pool->angle[i] = pool->angle.at(last);
+        pool->spin[i] = pool->spin.at(last);
+        pool->image[i] = pool->image.at(last);
+    }
+}
+
+QRectF OGParticleSystem::_Bounds(const Pool* pool)
+{
+    if (pool->count == 0) return QRectF();
+
+    const float* x = pool->x.constData();
+    const float* y = pool->y.constData();
+    float left = x[0];
+    float right = x[0];
+    float top = y[0];
+    float bottom = y[0];
+
+    for (int i = 1; i < pool->count; i++)
+    {
+        left = qMin(left, x[i]);
+        right = qMax(right, x[i]);
+        top = qMin(top, y[i]);
+        bottom = qMax(bottom, y[i]);
+    }
+
+    float e = pool->extent;
+
+    return QRectF(QPointF(left - e, top - e), QPointF(right + e, bottom + e));
+}
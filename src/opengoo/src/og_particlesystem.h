@@ -0,0 +1,91 @@
+#ifndef OG_PARTICLESYSTEM_H
+#define OG_PARTICLESYSTEM_H
+
+#include "og_sprite.h"
+
+#include <QHash>
+#include <QList>
+#include <QPainter>
+#include <QPair>
+#include <QRectF>
+#include <QVector>
+
+struct WOGParticleEffect;
+struct WOGEffectParticle;
+struct OGBallState;
+struct OGRenderStats;
+class WOGResources;
+
+// The particles of the fx.xml effects, updated and painted on the GUI
+// thread. An emitter has a pool for each particle type of its effect. A pool
+// has a fixed capacity and keeps its particles as arrays of floats, one per
+// property, so nothing is allocated per particle and the update loops are
+// plain float arithmetic the compiler vectorizes. A dead particle is
+// replaced by the last one, the live particles stay at the front.
+//
+// A point emitter outside of the camera doesn't emit, move or paint its
+// particles. The particles of an ambient effect fill the camera and wrap
+// around its edges. A pool is painted with one drawPixmapFragments() call
+// per image.
+class OGParticleSystem
+{
+    public:
+        OGParticleSystem();
+        ~OGParticleSystem();
+
+        // The images of the effects are looked up in the resources
+        void SetResources(const WOGResources* resources)
+        {
+            resources_ = resources;
+        }
+
+        void Clear();
+
+        // pos is in the scene coordinates, pretick in frames
+        void AddEmitter(const WOGParticleEffect* effect, const QPointF &pos
+                        , float pretick = 0);
+
+        // The emitters follow the balls showing an effect. An emitter stops
+        // emitting when its ball stops showing the effect and is removed
+        // when its particles are gone.
+        void UpdateBalls(const QVector<OGBallState> &balls);
+
+        // dt is in seconds
+        void Update(float dt, const QRectF &view);
+
+        // The effects over the balls are painted by the call with overball
+        void Paint(QPainter* painter, const QRectF &view, bool overball
+                   , OGRenderStats* stats);
+
+        int Count() const;
+
+    private:
+        struct Pool;
+        struct Emitter;
+
+        typedef QPair<const void*, const WOGParticleEffect*> BallKey;
+
+        const WOGResources* resources_;
+        QList<Emitter*> emitters_;
+        QHash<BallKey, Emitter*> ballEmitters_;
+        QVector<QPainter::PixmapFragment> fragments_;
+
+        OGParticleSystem(const OGParticleSystem&);
+        OGParticleSystem& operator=(const OGParticleSystem&);
+
+        Emitter* _CreateEmitter(const WOGParticleEffect* effect
+                                , const QPointF &pos);
+        void _Simulate(Emitter* emitter, float dt);
+        void _Fill(Emitter* emitter, const QRectF &view);
+        void _Wrap(Emitter* emitter, const QRectF &view);
+        void _Paint(QPainter* painter, Pool* pool, float zoom);
+
+        static int _Capacity(const WOGParticleEffect* effect
+                             , const WOGEffectParticle &particle);
+        static void _Spawn(Pool* pool, float x, float y);
+        static void _Move(Pool* pool, float dt);
+        static void _Kill(Pool* pool);
+        static QRectF _Bounds(const Pool* pool);
+};
+
+#endif // OG_PARTICLESYSTEM_H
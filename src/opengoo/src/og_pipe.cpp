@@ -3,15 +3,16 @@
 #include <QPointer>
 
 #include "og_pipe.h"
-#include "opengoo.h"
+#include "og_world.h"
 #include "og_sprite.h"
 #include "wog_pipe.h"
 #include "spritefactory.h"
 
 
-OGPipe::OGPipe(WOGPipe* a_pipe)
+OGPipe::OGPipe(WOGPipe* a_pipe, OGWorld* a_world)
+    : m_world(a_world)
 {
-    SpriteFactory factory;
+    SpriteFactory factory(a_world->resrcdata());
 
     QString type = (a_pipe->type.isEmpty() ? "NORMAL" : a_pipe->type);
     auto src = factory.CreateImageSource("IMAGE_GLOBAL_PIPE_" + type);
@@ -99,8 +100,3 @@ void OGPipe::_Open()
     m_cap[open]->SetVisible(true);
     m_cap[closed]->SetVisible(false);
 }
-
-OGWorld* OGPipe::GetWorld()
-{
-    return OpenGOO::instance()->GetWorld();
-}
@@ -28,8 +28,10 @@ class OGPipe : public OGIPipe
     virtual void _Open();
     virtual void _Painter(QPainter*) {}
 
-    OGWorld* GetWorld();
+    OGWorld* m_world;
+
+    OGWorld* GetWorld() { return m_world; }
 
 public:
-    OGPipe(WOGPipe* a_pipe);
+    OGPipe(WOGPipe* a_pipe, OGWorld* a_world);
 };
@@ -0,0 +1,142 @@
+#include "og_primitivebatch.h"
+
+#include <QFontMetricsF>
+#include <QPainter>
+
+OGPrimitiveBatch::OGPrimitiveBatch()
+    : font_("Times", 12, QFont::Bold)
+{
+    ascent_ = QFontMetricsF(font_).ascent();
+}
+
+void OGPrimitiveBatch::AddLine(const QPointF &p1, const QPointF &p2
+                               , const QPen &pen)
+{
+    _GetBatch(pen, Qt::NoBrush)->lines.append(QLineF(p1, p2));
+}
+
+void OGPrimitiveBatch::AddCircle(const QPointF &center, qreal radius
+                                 , const QPen &pen)
+{
+    QRectF rect(center.x() - radius, center.y() - radius
+                , radius * 2, radius * 2);
+
+    _GetBatch(pen, Qt::NoBrush)->ellipses.append(rect);
+}
+
+void OGPrimitiveBatch::AddPolygon(const QPolygonF &polygon
+                                  , const QBrush &brush)
+{
+    _GetBatch(Qt::NoPen, brush)->polygons.append(polygon);
+}
+
+void OGPrimitiveBatch::AddLabel(const QPointF &pos, int number
+                                , const QColor &color)
+{
+    Label label = {pos, number, color};
+    labels_.append(label);
+}
+
+void OGPrimitiveBatch::Flush(QPainter* painter)
+{
+    painter->save();
+
+    // Filled geometry is under the outlines
+    for (int i = 0; i < batches_.size(); i++)
+    {
+        Batch &b = batches_[i];
+
+        if (b.polygons.isEmpty()) continue;
+
+        painter->setPen(b.pen);
+        painter->setBrush(b.brush);
+
+        Q_FOREACH (const QPolygonF &polygon, b.polygons)
+        {
+            painter->drawPolygon(polygon);
+        }
+    }
+
+    for (int i = 0; i < batches_.size(); i++)
+    {
+        Batch &b = batches_[i];
+
+        if (b.lines.isEmpty() && b.ellipses.isEmpty()) continue;
+
+        painter->setPen(b.pen);
+        painter->setBrush(b.brush);
+
+        if (!b.lines.isEmpty())
+            painter->drawLines(b.lines.constData(), b.lines.size());
+
+        for (int j = 0; j < b.ellipses.size(); j++)
+        {
+            painter->drawEllipse(b.ellipses.at(j));
+        }
+    }
+
+    if (!labels_.isEmpty())
+    {
+        painter->setFont(font_);
+
+        QColor color;
+
+        for (int i = 0; i < labels_.size(); i++)
+        {
+            const Label &label = labels_.at(i);
+
+            if (i == 0 || label.color != color)
+            {
+                color = label.color;
+                painter->setPen(color);
+            }
+
+            painter->drawStaticText(label.pos - QPointF(0, ascent_)
+                                    , _GetText(label.number));
+        }
+    }
+
+    painter->restore();
+
+    // resize() keeps the allocated memory for the next frame
+    for (int i = 0; i < batches_.size(); i++)
+    {
+        batches_[i].lines.resize(0);
+        batches_[i].ellipses.resize(0);
+        batches_[i].polygons.resize(0);
+    }
+
+    labels_.resize(0);
+}
+
+OGPrimitiveBatch::Batch* OGPrimitiveBatch::_GetBatch(const QPen &pen
+                                                     , const QBrush &brush)
+{
+    // There are only a few colours in a frame
+    for (int i = 0; i < batches_.size(); i++)
+    {
+        if (batches_[i].pen == pen && batches_[i].brush == brush)
+            return &batches_[i];
+    }
+
+    batches_.append(Batch());
+    batches_.last().pen = pen;
+    batches_.last().brush = brush;
+
+    return &batches_.last();
+}
+
+const QStaticText &OGPrimitiveBatch::_GetText(int number)
+{
+    QHash<int, QStaticText>::iterator it = texts_.find(number);
+
+    if (it == texts_.end())
+    {
+        QStaticText text(QString::number(number));
+        text.setTextFormat(Qt::PlainText);
+        text.prepare(QTransform(), font_);
+        it = texts_.insert(number, text);
+    }
+
+    return it.value();
+}
@@ -0,0 +1,63 @@
+#ifndef OG_PRIMITIVEBATCH_H
+#define OG_PRIMITIVEBATCH_H
+
+#include <QBrush>
+#include <QFont>
+#include <QHash>
+#include <QLineF>
+#include <QPen>
+#include <QPolygonF>
+#include <QRectF>
+#include <QStaticText>
+#include <QVector>
+
+class QPainter;
+
+// Collects the debug primitives of a frame (balls, strands, geometry) and
+// draws them grouped by pen and brush, so the painter state is changed once
+// per colour instead of once per object. The arrays keep their capacity
+// between frames.
+class OGPrimitiveBatch
+{
+    public:
+        OGPrimitiveBatch();
+
+        void AddLine(const QPointF &p1, const QPointF &p2, const QPen &pen);
+        void AddCircle(const QPointF &center, qreal radius, const QPen &pen);
+        void AddPolygon(const QPolygonF &polygon, const QBrush &brush);
+
+        // The number is drawn with the label font, its baseline at the pos
+        void AddLabel(const QPointF &pos, int number, const QColor &color);
+
+        // Draws and removes the collected primitives
+        void Flush(QPainter* painter);
+
+    private:
+        struct Batch
+        {
+            QPen pen;
+            QBrush brush;
+            QVector<QLineF> lines;
+            QVector<QRectF> ellipses;
+            QVector<QPolygonF> polygons;
+        };
+
+        struct Label
+        {
+            QPointF pos;
+            int number;
+            QColor color;
+        };
+
+        QVector<Batch> batches_;
+        QVector<Label> labels_;
+
+        QFont font_;
+        qreal ascent_;
+        QHash<int, QStaticText> texts_;
+
+        Batch* _GetBatch(const QPen &pen, const QBrush &brush);
+        const QStaticText &_GetText(int number);
+};
+
+#endif // OG_PRIMITIVEBATCH_H
@@ -2,11 +2,12 @@
 #include "physics.h"
 #include "og_world.h"
 #include "og_userdata.h"
+#include "og_primitivebatch.h"
 
 OGRectangle::OGRectangle(WOGRectangle* rect, WOGMaterial* material)
     : OGIBody(rect, material)
 {
-    OGPhysicsBody* obj;
+    OGPhysicsBody* obj = 0;
 
     QPointF position = rect->position;
     QSizeF size = rect->size;
@@ -22,12 +23,10 @@ OGRectangle::OGRectangle(WOGRectangle* rect, WOGMaterial* material)
                               , data);
     }
 
-    body = obj->body;
-    fixture = obj->fixture;
-    shape = obj->shape;
+    if (obj) TakeOver(obj);
 }
 
-void OGRectangle::_Draw(QPainter* p)
+void OGRectangle::_Draw(OGPrimitiveBatch* batch)
 {
     if (debug_)
     {
@@ -36,7 +35,7 @@ void OGRectangle::_Draw(QPainter* p)
         int vertexCount = rect->m_vertexCount;
 
         b2Vec2 v;
-        QPointF points[4];
+        QPolygonF points(vertexCount);
 
         for (int i = 0; i < vertexCount; ++i)
         {
@@ -46,12 +45,6 @@ void OGRectangle::_Draw(QPainter* p)
 
         QColor greenColor(0, 255, 0, 100);
 
-        p->save();
-
-        p->setPen(Qt::transparent);
-        p->setBrush(greenColor);
-        p->drawPolygon(points, 4);
-
-        p->restore();
+        batch->AddPolygon(points, greenColor);
     }
 }
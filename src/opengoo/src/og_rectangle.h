@@ -3,11 +3,12 @@
 
 #include "og_ibody.h"
 #include "wog_scene.h"
-#include <QPainter>
+
+class OGPrimitiveBatch;
 
 class OGRectangle : public OGIBody
 {
-    void _Draw(QPainter* p);
+    void _Draw(OGPrimitiveBatch* batch);
 
 public:
     OGRectangle(WOGRectangle* rect, WOGMaterial* material);
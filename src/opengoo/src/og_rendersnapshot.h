@@ -0,0 +1,59 @@
+#ifndef OG_RENDERSNAPSHOT_H
+#define OG_RENDERSNAPSHOT_H
+
+#include <QColor>
+#include <QLineF>
+#include <QPointF>
+#include <QRectF>
+#include <QVector>
+
+struct WOGParticleEffect;
+
+// An effect of fx.xml shown in the current state of the ball
+struct OGBallEffect
+{
+    const WOGParticleEffect* effect;
+    bool overball;
+};
+
+// Drawable state of a ball at the end of a simulation step
+struct OGBallState
+{
+    const void* ball; // identifies the ball, e.g. for its particles
+    QPointF position;
+    QLineF direction;
+    qreal radius;
+    QColor color;
+    int id;
+    QRectF bounds;
+    QVector<QPointF> joints;
+    QVector<OGBallEffect> effects;
+};
+
+struct OGStrandState
+{
+    QPointF p1;
+    QPointF p2;
+    QRectF bounds;
+};
+
+// Everything _Paint needs from the world. It's filled by the simulation
+// thread and handed over to the GUI thread as a whole.
+struct OGRenderSnapshot
+{
+    QVector<OGBallState> balls;
+    QVector<OGStrandState> strands;
+
+    bool hasNearestBall;
+    QPointF nearestBall;
+
+    int exitBalls;
+
+    // OGFrameScheduler::timestamp() of the oldest input applied
+    // before this step, 0 if there was none
+    qint64 inputTime;
+
+    OGRenderSnapshot() : hasNearestBall(false), exitBalls(0), inputTime(0) {}
+};
+
+#endif // OG_RENDERSNAPSHOT_H
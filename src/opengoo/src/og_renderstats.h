@@ -0,0 +1,20 @@
+#ifndef OG_RENDERSTATS_H
+#define OG_RENDERSTATS_H
+
+// Per-frame counters of the objects which were painted and the objects
+// which were skipped because they were outside of the camera.
+struct OGRenderStats
+{
+    int drawn;
+    int culled;
+
+    OGRenderStats() : drawn(0), culled(0) {}
+
+    void Reset()
+    {
+        drawn = 0;
+        culled = 0;
+    }
+};
+
+#endif // OG_RENDERSTATS_H
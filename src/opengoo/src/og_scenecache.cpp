@@ -0,0 +1,242 @@
+#include "og_scenecache.h"
+#include "og_renderstats.h"
+
+#include <QPainter>
+#include <QRectF>
+#include <QtCore/qmath.h>
+
+#include <limits>
+
+namespace
+{
+const int TILE_SIZE = 512;     // in pixels
+const qint64 TILE_BYTES = qint64(TILE_SIZE) * TILE_SIZE * 4; // ARGB32
+const qint64 MAX_BYTES = 64 * TILE_BYTES;  // 64 MB for all the caches
+const qint64 HIGH_WATER = MAX_BYTES / 2;   // the hidden tiles are dropped
+const float SCALE_STEPS = 4.0f; // quantization steps per octave
+
+inline quint64 TileKey(int col, int row)
+{
+    return (quint64(quint32(col)) << 32) | quint32(row);
+}
+
+inline int TileCol(quint64 key) { return qint32(key >> 32); }
+inline int TileRow(quint64 key) { return qint32(key & 0xFFFFFFFF); }
+}
+
+qint64 OGSceneCache::bytes_ = 0;
+
+OGSceneCache::OGSceneCache()
+    : scale_(0)
+    , minDepth_(-std::numeric_limits<float>::infinity())
+    , maxDepth_(std::numeric_limits<float>::infinity())
+    , drawn_(0)
+    , culled_(0)
+{
+}
+
+OGSceneCache::~OGSceneCache()
+{
+    _ClearTiles();
+}
+
+void OGSceneCache::Clear()
+{
+    _ClearTiles();
+    scale_ = 0;
+}
+
+void OGSceneCache::SetDepthRange(float min, float max)
+{
+    minDepth_ = min;
+    maxDepth_ = max;
+    Clear();
+}
+
+void OGSceneCache::Paint(QPainter* painter, QMap<float, OGLayer>* layers
+                         , OGRenderStats* stats)
+{
+    float scale = _QuantizeScale(qAbs(painter->combinedTransform().m11()));
+
+    if (scale <= 0 || _Begin(layers) == _End(layers)) return;
+
+    if (_TakeDirty(layers) || scale != scale_)
+    {
+        _ClearTiles();
+        scale_ = scale;
+    }
+
+    QRectF window = painter->window();
+    float size = TILE_SIZE / scale_;
+
+    int col1 = qFloor(window.left() / size);
+    int col2 = qFloor(window.right() / size);
+    int row1 = qFloor(window.top() / size);
+    int row2 = qFloor(window.bottom() / size);
+
+    QRect tiles(QPoint(col1, row1), QPoint(col2, row2));
+    qint64 missing = 0;
+
+    for (int row = row1; row <= row2; row++)
+    {
+        for (int col = col1; col <= col2; col++)
+        {
+            if (!tiles_.contains(TileKey(col, row))) missing += TILE_BYTES;
+        }
+    }
+
+    if (bytes_ >= HIGH_WATER || bytes_ + missing > MAX_BYTES)
+        _DropHidden(tiles);
+
+    if (bytes_ + missing > MAX_BYTES)
+    {
+        _ClearTiles();
+        _PaintDirect(painter, layers, stats);
+
+        return;
+    }
+
+    for (int row = row1; row <= row2; row++)
+    {
+        for (int col = col1; col <= col2; col++)
+        {
+            QImage &tile = tiles_[TileKey(col, row)];
+
+            if (tile.isNull())
+            {
+                _BuildTile(&tile, col, row, layers);
+                bytes_ += TILE_BYTES;
+            }
+
+            painter->drawImage(_TileRect(col, row), tile);
+        }
+    }
+
+    if (!stats) return;
+
+    if (tiles != countedTiles_) _Count(layers, tiles);
+
+    stats->drawn += drawn_;
+    stats->culled += culled_;
+}
+
+void OGSceneCache::_BuildTile(QImage* tile, int col, int row
+                              , QMap<float, OGLayer>* layers)
+{
+    QRectF rect = _TileRect(col, row);
+
+    *tile = QImage(TILE_SIZE, TILE_SIZE, QImage::Format_ARGB32_Premultiplied);
+    tile->fill(Qt::transparent);
+
+    QPainter painter(tile);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    painter.scale(scale_, scale_);
+    painter.translate(-rect.left(), -rect.top());
+
+    QMap<float, OGLayer>::iterator end = _End(layers);
+
+    for (QMap<float, OGLayer>::iterator i = _Begin(layers); i != end; ++i)
+    {
+        i.value().Paint(&painter, rect);
+    }
+}
+
+void OGSceneCache::_ClearTiles()
+{
+    bytes_ -= tiles_.size() * TILE_BYTES;
+    tiles_.clear();
+    countedTiles_ = QRect();
+}
+
+void OGSceneCache::_DropHidden(const QRect &tiles)
+{
+    QMutableHashIterator<quint64, QImage> i(tiles_);
+
+    while (i.hasNext())
+    {
+        i.next();
+
+        if (!tiles.contains(TileCol(i.key()), TileRow(i.key())))
+        {
+            i.remove();
+            bytes_ -= TILE_BYTES;
+        }
+    }
+}
+
+// The sprites are painted and counted on every frame, as with no cache
+void OGSceneCache::_PaintDirect(QPainter* painter
+                                , QMap<float, OGLayer>* layers
+                                , OGRenderStats* stats)
+{
+    QRectF window = painter->window();
+
+    QMap<float, OGLayer>::iterator end = _End(layers);
+
+    for (QMap<float, OGLayer>::iterator i = _Begin(layers); i != end; ++i)
+    {
+        i.value().Paint(painter, window, stats);
+    }
+}
+
+void OGSceneCache::_Count(QMap<float, OGLayer>* layers, const QRect &tiles)
+{
+    QRectF rect = _TileRect(tiles.left(), tiles.top())
+                  | _TileRect(tiles.right(), tiles.bottom());
+    OGRenderStats stats;
+
+    QMap<float, OGLayer>::iterator end = _End(layers);
+
+    for (QMap<float, OGLayer>::iterator i = _Begin(layers); i != end; ++i)
+    {
+        i.value().Cull(rect, &stats);
+    }
+
+    countedTiles_ = tiles;
+    drawn_ = stats.drawn;
+    culled_ = stats.culled;
+}
+
+QRectF OGSceneCache::_TileRect(int col, int row) const
+{
+    float size = TILE_SIZE / scale_;
+
+    return QRectF(col * size, row * size, size, size);
+}
+
+bool OGSceneCache::_TakeDirty(QMap<float, OGLayer>* layers)
+{
+    bool dirty = false;
+
+    QMap<float, OGLayer>::iterator end = _End(layers);
+
+    for (QMap<float, OGLayer>::iterator i = _Begin(layers); i != end; ++i)
+    {
+        if (i.value().TakeDirty()) dirty = true;
+    }
+
+    return dirty;
+}
+
+QMap<float, OGLayer>::iterator
+OGSceneCache::_Begin(QMap<float, OGLayer>* layers) const
+{
+    return layers->lowerBound(minDepth_);
+}
+
+QMap<float, OGLayer>::iterator
+OGSceneCache::_End(QMap<float, OGLayer>* layers) const
+{
+    return layers->lowerBound(maxDepth_);
+}
+
+// Rounds the scale up to a fraction of an octave, so a zooming camera
+// doesn't rebuild the tiles on every frame
+float OGSceneCache::_QuantizeScale(float scale)
+{
+    if (scale <= 0) return 0;
+
+    float steps = qCeil(qLn(scale) / M_LN2 * SCALE_STEPS);
+
+    return qPow(2.0f, steps / SCALE_STEPS);
+}
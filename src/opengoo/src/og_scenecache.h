@@ -0,0 +1,76 @@
+#ifndef OG_SCENECACHE_H
+#define OG_SCENECACHE_H
+
+#include <QHash>
+#include <QImage>
+#include <QMap>
+#include <QRect>
+
+#include "og_layer.h"
+
+struct OGRenderStats;
+class QPainter;
+class QRectF;
+
+// Scene layers never move relative to the world, so they are flattened into
+// offscreen tiles at the current camera scale. A tile is rendered the first
+// time it becomes visible and then blitted until the scale changes or
+// a sprite of the scene is changed (e.g. a button hover or a pipe cap).
+//
+// A cache may take only the layers of a range of depths, the animated
+// sprites are painted between the caches of the ranges.
+//
+// The tiles of all the caches share one byte budget. When the visible tiles
+// don't fit in it (e.g. zoomed out on a large screen), the cache drops its
+// tiles and paints its layers directly until they fit again.
+class OGSceneCache
+{
+    public:
+        OGSceneCache();
+        ~OGSceneCache();
+
+        void Clear();
+
+        // The layers from min, up to but not including max
+        void SetDepthRange(float min, float max);
+
+        // The sprites of the visible tiles are counted when the tiles
+        // are rebuilt or others come into view; the frames in between
+        // add the same counts to the stats
+        void Paint(QPainter* painter, QMap<float, OGLayer>* layers
+                   , OGRenderStats* stats = 0);
+
+    private:
+        QHash<quint64, QImage> tiles_;
+        float scale_;
+        float minDepth_;
+        float maxDepth_;
+
+        QRect countedTiles_; // the columns and rows the counts are of
+        int drawn_;
+        int culled_;
+
+        static qint64 bytes_; // of the tiles of all the caches
+
+        Q_DISABLE_COPY(OGSceneCache)
+
+        void _BuildTile(QImage* tile, int col, int row
+                        , QMap<float, OGLayer>* layers);
+
+        QRectF _TileRect(int col, int row) const;
+
+        void _ClearTiles();
+        void _DropHidden(const QRect &tiles);
+        void _PaintDirect(QPainter* painter, QMap<float, OGLayer>* layers
+                          , OGRenderStats* stats);
+
+        bool _TakeDirty(QMap<float, OGLayer>* layers);
+        void _Count(QMap<float, OGLayer>* layers, const QRect &tiles);
+
+        QMap<float, OGLayer>::iterator _Begin(QMap<float, OGLayer>* layers) const;
+        QMap<float, OGLayer>::iterator _End(QMap<float, OGLayer>* layers) const;
+
+        static float _QuantizeScale(float scale);
+};
+
+#endif // OG_SCENECACHE_H
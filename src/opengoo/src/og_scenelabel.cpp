@@ -0,0 +1,37 @@
+#include "og_scenelabel.h"
+#include "wog_scene.h"
+#include "GameEngine/textrenderer.h"
+
+#include <QPainter>
+
+OGSceneLabel::OGSceneLabel(const WOGLabel &config, const QString &text
+                           , const QFont &font)
+    : text_(text)
+    , font_(font)
+    , position_(config.position.x(), -config.position.y())
+    , rotation_(config.rotation)
+    , scale_(config.scale)
+    , overlay_(config.overlay)
+    , screenspace_(config.screenspace)
+{
+    // The position is the middle of the left or the right edge of the text
+    if (config.align == "left") flags_ = Qt::AlignLeft | Qt::AlignVCenter;
+    else if (config.align == "right") flags_ = Qt::AlignRight | Qt::AlignVCenter;
+    else flags_ = Qt::AlignCenter;
+}
+
+void OGSceneLabel::Paint(QPainter* painter)
+{
+    painter->save();
+    painter->translate(position_);
+
+    if (rotation_ != 0) painter->rotate(rotation_);
+
+    painter->scale(scale_, scale_);
+
+    // An empty rect at the position, the text is aligned around it
+    og::TextRenderer::Draw(painter, QRectF(), flags_, text_, font_
+                           , Qt::white);
+
+    painter->restore();
+}
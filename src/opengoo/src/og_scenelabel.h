@@ -0,0 +1,40 @@
+#ifndef OG_SCENELABEL_H
+#define OG_SCENELABEL_H
+
+#include <QFont>
+#include <QPointF>
+#include <QString>
+
+#include "GameEngine/memorytracker.h"
+
+struct WOGLabel;
+class QPainter;
+
+// A text of the scene, painted with og::TextRenderer. The screen space
+// labels are painted over everything in the screen coordinates, the
+// overlay labels over the balls and the others over the scene layers.
+class OGSceneLabel : og::Tracked<OGSceneLabel, og::MemoryTracker::SPRITES>
+{
+    public:
+        OGSceneLabel(const WOGLabel &config, const QString &text
+                     , const QFont &font);
+
+        // In the scene or the screen coordinates, with the origin
+        // in the center of the screen
+        void Paint(QPainter* painter);
+
+        bool IsOverlay() const { return overlay_; }
+        bool IsScreenSpace() const { return screenspace_; }
+
+    private:
+        QString text_;
+        QFont font_;
+        QPointF position_;
+        float rotation_;
+        float scale_;
+        int flags_;
+        bool overlay_;
+        bool screenspace_;
+};
+
+#endif // OG_SCENELABEL_H
@@ -0,0 +1,143 @@
+#include "og_simulation.h"
+#include "GameEngine/og_framescheduler.h"
+
+#include <QElapsedTimer>
+#include <QMutexLocker>
+
+OGSimulation::OGSimulation(Client* client)
+    : client_(client), running_(false), paused_(false), maxSteps_(4)
+{
+    frame_ = &snapshots_.Front();
+}
+
+OGSimulation::~OGSimulation()
+{
+    Stop();
+}
+
+void OGSimulation::Start()
+{
+    if (isRunning()) return;
+
+    OGInputEvent ev;
+
+    while (input_.Pop(&ev)) {}
+
+    // The thread isn't running, both sides of the buffer are ours. An empty
+    // snapshot hides the last step of the previous world until the first
+    // step of this one is published.
+    snapshots_.Back() = OGRenderSnapshot();
+    snapshots_.Publish();
+    frame_ = &snapshots_.Front();
+
+    running_ = true;
+    start();
+}
+
+void OGSimulation::Stop()
+{
+    running_ = false;
+    wait();
+}
+
+bool OGSimulation::PostInput(OGInputEvent ev)
+{
+    ev.time = og::OGFrameScheduler::timestamp();
+
+    return input_.Push(ev);
+}
+
+bool OGSimulation::NextFrame()
+{
+    bool fresh;
+    frame_ = &snapshots_.Front(&fresh);
+
+    return fresh;
+}
+
+// Returns the time of the oldest event, or inputTime if it's older
+qint64 OGSimulation::_ApplyInput(qint64 inputTime)
+{
+    OGInputEvent ev;
+    OGInputEvent move;
+    bool hasMove = false;
+
+    while (input_.Pop(&ev))
+    {
+        if (inputTime == 0 || ev.time < inputTime) inputTime = ev.time;
+
+        if (ev.type == OGInputEvent::MOUSE_MOVE)
+        {
+            move = ev;
+            hasMove = true;
+            continue;
+        }
+
+        // A press or a release must find the pointer where it happened
+        if (hasMove)
+        {
+            client_->SimInput(move);
+            hasMove = false;
+        }
+
+        client_->SimInput(ev);
+    }
+
+    if (hasMove) client_->SimInput(move);
+
+    return inputTime;
+}
+
+void OGSimulation::run()
+{
+    QElapsedTimer clock;
+    clock.start();
+
+    const double STEP_TIME = StepTime();
+
+    double lastTime = 0;
+    double accumulator = 0;
+    double deadline = 0;
+
+    // Input of a snapshot which was replaced before the GUI thread read it
+    qint64 pendingInput = 0;
+
+    while (running_)
+    {
+        double time = clock.nsecsElapsed() / 1e6;
+        accumulator += time - lastTime;
+        lastTime = time;
+
+        int steps = accumulator / STEP_TIME;
+        accumulator -= steps * STEP_TIME;
+
+        if (steps > maxSteps_)
+        {
+            steps = maxSteps_;
+            accumulator = 0;
+        }
+
+        {
+            QMutexLocker locker(&mutex_);
+
+            qint64 inputTime = _ApplyInput(pendingInput);
+
+            if (!paused_ && steps > 0) client_->SimStep(steps);
+
+            OGRenderSnapshot &snapshot = snapshots_.Back();
+            client_->SimSnapshot(&snapshot);
+            snapshot.inputTime = inputTime;
+
+            bool dropped = snapshots_.Publish();
+            pendingInput = dropped ? snapshots_.Back().inputTime : 0;
+        }
+
+        // Absolute deadlines, so the rounding of the sleep time to
+        // milliseconds doesn't accumulate
+        deadline += STEP_TIME;
+        time = clock.nsecsElapsed() / 1e6;
+
+        if (deadline < time) deadline = time;
+        else msleep(deadline - time);
+    }
+}
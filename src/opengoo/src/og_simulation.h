@@ -0,0 +1,100 @@
+#ifndef OG_SIMULATION_H
+#define OG_SIMULATION_H
+
+#include <atomic>
+
+#include <QMutex>
+#include <QPoint>
+#include <QThread>
+
+#include "OGLib/ringbuffer.h"
+#include "OGLib/triplebuffer.h"
+#include "og_rendersnapshot.h"
+
+struct OGInputEvent
+{
+    enum Type
+    {
+        MOUSE_DOWN
+        , MOUSE_UP
+        , MOUSE_MOVE
+    };
+
+    Type type;
+    QPoint pos; // in the scene coordinates
+    qint64 time; // set by PostInput()
+};
+
+// Runs the game simulation on its own thread at a fixed rate. Steps of
+// STEP_TIME are taken from an accumulator; after a stall no more than
+// maxSteps steps are taken in one tick and the rest of the time is dropped. The GUI
+// thread talks to it only through the input queue and reads the result of
+// the last step from a triple buffered snapshot, so neither side waits for
+// the other. Code which has to change the world from the GUI thread must
+// hold mutex(); it's locked by the simulation for the whole step.
+//
+// The input is applied once per tick. Mouse moves are coalesced to the last
+// one before each press or release, the client sees only the pointer
+// positions that matter. Every snapshot carries the time of the oldest
+// input it reflects, including the input of the snapshots the GUI thread
+// never got to see.
+class OGSimulation : public QThread
+{
+    public:
+        class Client
+        {
+            public:
+                virtual ~Client() {}
+
+                virtual void SimInput(const OGInputEvent &ev) = 0;
+                // Called once per tick, the world has to be advanced
+                // by the given number of fixed steps
+                virtual void SimStep(int steps) = 0;
+                virtual void SimSnapshot(OGRenderSnapshot* snapshot) = 0;
+        };
+
+        explicit OGSimulation(Client* client);
+        ~OGSimulation();
+
+        // Start() drops the input and the snapshot left from the previous
+        // run, Stop() returns when the thread has finished.
+        void Start();
+        void Stop();
+
+        void SetPaused(bool paused) { paused_ = paused; }
+        void SetMaxSteps(int steps) { maxSteps_ = steps; }
+
+        static double StepTime() { return 1000.0 / STEPS_PER_SECOND; }
+
+        // Stamps the event with OGFrameScheduler::timestamp().
+        // Returns false if the queue is full.
+        bool PostInput(OGInputEvent ev);
+
+        // GUI thread only. NextFrame() takes the latest snapshot and returns
+        // true if it's a new one, Snapshot() returns it until the next call,
+        // so the whole frame is built from the same step.
+        bool NextFrame();
+        const OGRenderSnapshot& Snapshot() const { return *frame_; }
+
+        QMutex* mutex() { return &mutex_; }
+
+    protected:
+        void run();
+
+    private:
+        enum { QUEUE_SIZE = 256, STEPS_PER_SECOND = 60 };
+
+        Client* client_;
+        QMutex mutex_;
+        std::atomic<bool> running_;
+        std::atomic<bool> paused_;
+        std::atomic<int> maxSteps_;
+
+        oglib::RingBuffer<OGInputEvent, QUEUE_SIZE> input_;
+        oglib::TripleBuffer<OGRenderSnapshot> snapshots_;
+        const OGRenderSnapshot* frame_;
+
+        qint64 _ApplyInput(qint64 inputTime);
+};
+
+#endif // OG_SIMULATION_H
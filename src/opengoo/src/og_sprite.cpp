@@ -1,5 +1,7 @@
 #include "og_sprite.h"
 
+#include <QtCore/qmath.h>
+
 void OGSprite::Paint(QPainter* p)
 {
     if (!m_visible)
@@ -17,7 +19,13 @@ void OGSprite::Paint(QPainter* p)
 
     p->scale(sx, sy);
     p->setOpacity(m_alpha);
-    m_source->Render(*p, target, m_clipRect);
+
+    // Device pixels per image pixel, picks the mip level
+    QTransform t = p->combinedTransform();
+    float scale = qMax(qSqrt(t.m11() * t.m11() + t.m12() * t.m12()),
+                       qSqrt(t.m21() * t.m21() + t.m22() * t.m22()));
+
+    m_source->Render(*p, target, m_clipRect, scale);
     p->restore();
 }
 
@@ -40,4 +48,22 @@ void OGSprite::CenterOrigin()
 {
     m_offsetX = m_source->GetWidth() / 2.0f;
     m_offsetY = m_source->GetHeight() / 2.0f;
+    SetTransformChanged();
+}
+
+const QRectF& OGSprite::GetBounds() const
+{
+    if (!m_boundsValid)
+    {
+        QTransform t;
+        t.translate(GetX(), GetY());
+        t.rotate(GetAngle());
+        t.scale(m_scale * m_scaleX, m_scale * m_scaleY);
+
+        m_bounds = t.mapRect(QRectF(-m_offsetX, -m_offsetY
+                                    , m_clipRect.width(), m_clipRect.height()));
+        m_boundsValid = true;
+    }
+
+    return m_bounds;
 }
@@ -8,13 +8,14 @@
 #include "wog_vobject.h"
 
 #include "GameEngine/imagesource.h"
+#include "GameEngine/memorytracker.h"
 
 
 typedef std::shared_ptr<og::ImageSource> ImageSourcePtr;
 
 class QPainter;
 
-class OGSprite
+class OGSprite : og::Tracked<OGSprite, og::MemoryTracker::SPRITES>
 {    
     QVector2D m_position;
     ImageSourcePtr m_source;
@@ -29,6 +30,15 @@ class OGSprite
     float m_depth;
     QRectF m_clipRect;
     QColor m_colorize;
+    bool m_dirty;
+    mutable QRectF m_bounds;
+    mutable bool m_boundsValid;
+
+    void SetTransformChanged()
+    {
+        m_dirty = true;
+        m_boundsValid = false;
+    }
 
     void Init()
     {
@@ -42,6 +52,8 @@ class OGSprite
         m_alpha = 1.0f;
         m_depth = 0.0f;
         m_clipRect = QRectF(0, 0, GetWidth(), GetHeight());
+        m_dirty = true;
+        m_boundsValid = false;
     }
 
 public:
@@ -70,6 +82,7 @@ public:
     void SetAngle(float a_angle)
     {
         m_angle = a_angle;
+        SetTransformChanged();
     }
 
     float GetAngle() const
@@ -92,22 +105,33 @@ public:
     void SetX(float a_x)
     {
         m_position.setX(a_x);
+        SetTransformChanged();
     }
 
     void SetY(float a_y)
     {
         m_position.setY(a_y);
+        SetTransformChanged();
     }
 
     void SetVisible(bool a_visible)
     {
+        if (m_visible != a_visible)
+            m_dirty = true;
+
         m_visible = a_visible;
     }
 
+    bool IsVisible() const
+    {
+        return m_visible;
+    }
+
     void SetPosition(float a_x, float a_y)
     {
         m_position.setX(a_x);
         m_position.setY(a_y);
+        SetTransformChanged();
     }
 
     const QVector2D& GetPosition() const
@@ -128,16 +152,29 @@ public:
     void SetScaleX(float a_scale)
     {
         m_scaleX = a_scale;
+        SetTransformChanged();
     }
 
     void SetScaleY(float a_scale)
     {
         m_scaleY = a_scale;
+        SetTransformChanged();
+    }
+
+    float GetScaleX() const
+    {
+        return m_scaleX;
+    }
+
+    float GetScaleY() const
+    {
+        return m_scaleY;
     }
 
     void SetScale(float a_scale)
     {
         m_scale = a_scale;
+        SetTransformChanged();
     }
 
     float GetScaledWidth() const
@@ -153,6 +190,7 @@ public:
     void SetAlpha(float a_alpha)
     {
         m_alpha = a_alpha;
+        m_dirty = true;
     }
 
     float GetAlpha() const
@@ -173,15 +211,34 @@ public:
     void SetOffsetX(float a_offset)
     {
         m_offsetX = a_offset;
+        SetTransformChanged();
     }
 
     void SetOffsetY(float a_offset)
     {
         m_offsetY = a_offset;
+        SetTransformChanged();
     }
 
     void SetColorize(const QColor& a_color)
     {
        m_colorize = a_color;
+       m_dirty = true;
+    }
+
+    // World-space bounding box with the offset, rotation and scale
+    // applied. It's cached until the transform changes.
+    const QRectF& GetBounds() const;
+
+    // A sprite is dirty when its appearance has changed since
+    // the last ClearDirty(). Used by the cached scene layers.
+    bool IsDirty() const
+    {
+        return m_dirty;
+    }
+
+    void ClearDirty()
+    {
+        m_dirty = false;
     }
 };
@@ -3,7 +3,8 @@
 #include "og_userdata.h"
 #include "physics.h"
 
-#include <QPainter>
+#include "og_primitivebatch.h"
+#include "og_rendersnapshot.h"
 #include <QVector2D>
 
 using namespace og;
@@ -11,6 +12,9 @@ using namespace og;
 OGStrand::~OGStrand()
 {
     OGPhysicsEngine* physicsEngine = OGPhysicsEngine::GetInstance();
+
+    if (strand_) delete OGUserData::GetUserData(strand_->joint->GetUserData());
+
     physicsEngine->DestroyJoint(strand_);
 
     b1_->ReleaseStrand();
@@ -43,27 +47,32 @@ OGStrand::OGStrand(OGBall* gb1, OGBall* gb2, int id)
     }
 }
 
-void OGStrand::Paint(QPainter* painter, bool debug)
+void OGStrand::GetState(OGStrandState* state) const
+{
+    const qreal K = 10.0;
+
+    state->p1 = QPointF(b1_->GetX()*K, b1_->GetY()*K*(-1.0));
+    state->p2 = QPointF(b2_->GetX()*K, b2_->GetY()*K*(-1.0));
+    state->bounds = GetBounds();
+}
+
+void OGStrand::Paint(const OGStrandState &state, OGPrimitiveBatch* batch)
 {
-    Q_UNUSED(debug)
+    batch->AddLine(state.p1, state.p2, QPen(Qt::yellow,  2.0));
+}
 
-    int x1, y1, x2, y2;
+QRectF OGStrand::GetBounds() const
+{
+    if (!b1_ || !b2_) return QRectF();
 
     const qreal K = 10.0;
+    const qreal MARGIN = 2.0; // the pen width
 
-    if (b1_ && b2_)
-    {
-        x1 = b1_->GetX()*K;
-        y1 = b1_->GetY()*K*(-1.0);
-        x2 = b2_->GetX()*K;
-        y2 = b2_->GetY()*K*(-1.0);
-
-        QPen pen(Qt::yellow,  2.0);
-        painter->save();        
-        painter->setPen(pen);
-        painter->drawLine(QPointF(x1, y1), QPointF(x2, y2));
-        painter->restore();
-    }
+    QPointF p1(b1_->GetX()*K, b1_->GetY()*K*(-1.0));
+    QPointF p2(b2_->GetX()*K, b2_->GetY()*K*(-1.0));
+
+    return QRectF(p1, p2).normalized().adjusted(-MARGIN, -MARGIN
+                                                , MARGIN, MARGIN);
 }
 
 float OGStrand::GetLenghth()
@@ -4,7 +4,8 @@
 #include <OGPhysicsJoint>
 #include "og_ball.h"
 
-class QPainter;
+class OGPrimitiveBatch;
+struct OGStrandState;
 
 class OGStrand
 {
@@ -21,10 +22,17 @@ public:
     int id() const { return id_; }
     OGBall* b1() const { return b1_; }
     OGBall* b2() const { return b2_; }
+    // The climbers move along the strands with a joint only
+    bool HasJoint() const { return strand_ != 0; }
 
     float GetLenghth();
 
-    void Paint(QPainter* painter, bool debug=false);
+    // Only valid if both balls are set
+    void GetState(OGStrandState* state) const;
+    static void Paint(const OGStrandState &state, OGPrimitiveBatch* batch);
+
+    // Area covered by Paint() in the scene coordinates
+    QRectF GetBounds() const;
 };
 
 #endif // OG_STRAND_H
@@ -0,0 +1,402 @@
+#include "og_structurefreezer.h"
+#include "og_ball.h"
+#include "og_userdata.h"
+#include "physics.h"
+#include "GameEngine/metrics.h"
+#include "GameEngine/memorytracker.h"
+#include <OGPhysicsEngine>
+#include <logger.h>
+
+#include <QSet>
+#include <QVector>
+
+using namespace og;
+
+namespace
+{
+// Kinetic energy per unit of mass below which a component counts as still,
+// about 1 pixel per second
+const float ENERGY_THRESHOLD = 0.005f;
+
+// Resting bodies, e.g. a ball sitting on the structure, don't count
+inline bool IsMoving(b2Body* body)
+{
+    return body->GetType() == b2_dynamicBody && body->IsAwake()
+           && 0.5f * body->GetLinearVelocity().LengthSquared() > ENERGY_THRESHOLD;
+}
+
+inline bool IsExit(b2Fixture* fixture)
+{
+    return fixture->IsSensor()
+           && (fixture->GetFilterData().categoryBits & physics::EXIT);
+}
+
+inline OGBall* GetBall(b2Body* body)
+{
+    OGUserData* data = OGUserData::GetUserData(body->GetUserData());
+
+    if (!data || data->type != OGUserData::BALL) return 0;
+
+    return static_cast<OGBall*>(data->data);
+}
+
+// A copy of the ball's shape in the frame of the compound body
+bool CreateFixture(b2Body* body, b2Fixture* fixture, const b2Transform &xf)
+{
+    b2FixtureDef def;
+    def.friction = fixture->GetFriction();
+    def.restitution = fixture->GetRestitution();
+    def.filter = fixture->GetFilterData();
+    def.userData = fixture->GetUserData(); // the ball, for OGWorld::PickBall()
+
+    b2CircleShape circle;
+    b2PolygonShape polygon;
+
+    switch (fixture->GetType())
+    {
+    case b2Shape::e_circle:
+        circle = *static_cast<b2CircleShape*>(fixture->GetShape());
+        circle.m_p = b2Mul(xf, circle.m_p);
+        def.shape = &circle;
+        break;
+
+    case b2Shape::e_polygon:
+    {
+        const b2PolygonShape* shape
+            = static_cast<b2PolygonShape*>(fixture->GetShape());
+        b2Vec2 vertices[b2_maxPolygonVertices];
+
+        for (int i = 0; i < shape->m_vertexCount; i++)
+            vertices[i] = b2Mul(xf, shape->m_vertices[i]);
+
+        polygon.Set(vertices, shape->m_vertexCount);
+        def.shape = &polygon;
+        break;
+    }
+
+    default:
+        return false;
+    }
+
+    body->CreateFixture(&def);
+
+    return true;
+}
+}
+
+struct OGStructureFreezer::Structure
+        : Tracked<OGStructureFreezer::Structure, MemoryTracker::PHYSICS>
+{
+    b2Body* body;
+    QVector<OGBall*> balls;
+    QVector<b2Transform> poses; // of the ball bodies in the frame of body
+};
+
+OGStructureFreezer::OGStructureFreezer() : step_(0)
+{
+}
+
+OGStructureFreezer::~OGStructureFreezer()
+{
+    Clear();
+}
+
+void OGStructureFreezer::Clear()
+{
+    while (!structures_.isEmpty())
+        delete structures_.takeFirst();
+
+    frozen_.clear();
+    quietSteps_.clear();
+    step_ = 0;
+
+    _UpdateMetrics();
+}
+
+void OGStructureFreezer::Update(const QList<OGBall*> &balls)
+{
+    // Structures are few, the balls of a sleeping one cost nothing
+    for (int i = structures_.size() - 1; i >= 0; i--)
+    {
+        Structure* structure = structures_.at(i);
+
+        if (!structure->body->IsAwake()) continue;
+
+        if (_IsTouched(structure)) _Thaw(structure);
+        else _Sync(structure);
+    }
+
+    if (++step_ % CHECK_STEPS == 0) _FindSettled(balls);
+}
+
+void OGStructureFreezer::Thaw(OGBall* ball)
+{
+    if (Structure* structure = frozen_.value(ball)) _Thaw(structure);
+}
+
+void OGStructureFreezer::_FindSettled(const QList<OGBall*> &balls)
+{
+    QHash<OGBall*, bool> visited;
+    QList<OGBall*> component;
+
+    Q_FOREACH(OGBall * ball, balls)
+    {
+        if (!ball->IsAttached() || ball->IsFrozen() || visited.contains(ball))
+            continue;
+
+        component.clear();
+
+        bool complete = _CollectComponent(ball, &component, &visited);
+
+        if (!complete || !_IsQuiet(component))
+        {
+            Q_FOREACH(OGBall * b, component)
+            {
+                quietSteps_.remove(b);
+            }
+
+            continue;
+        }
+
+        // A ball which has just joined holds the whole component back
+        int settled = SETTLE_STEPS;
+
+        Q_FOREACH(OGBall * b, component)
+        {
+            int &steps = quietSteps_[b];
+            steps += CHECK_STEPS;
+            settled = qMin(settled, steps);
+        }
+
+        if (settled >= SETTLE_STEPS) _Freeze(component);
+    }
+}
+
+// Returns false if the component has a ball which can't be frozen
+bool OGStructureFreezer::_CollectComponent(OGBall* ball
+                                           , QList<OGBall*>* component
+                                           , QHash<OGBall*, bool>* visited) const
+{
+    bool complete = true;
+    QList<OGBall*> stack;
+
+    stack << ball;
+    visited->insert(ball, true);
+
+    while (!stack.isEmpty())
+    {
+        OGBall* b = stack.takeLast();
+        *component << b;
+
+        if (b->IsFrozen()) complete = false;
+
+        for (b2JointEdge* e = b->GetJoints(); e; e = e->next)
+        {
+            OGBall* other = GetBall(e->other);
+
+            if (!other)
+            {
+                complete = false;
+                continue;
+            }
+
+            if (visited->contains(other)) continue;
+
+            visited->insert(other, true);
+            stack << other;
+        }
+    }
+
+    return complete;
+}
+
+bool OGStructureFreezer::_IsQuiet(const QList<OGBall*> &component) const
+{
+    QSet<b2Body*> bodies;
+    float energy = 0;
+    float mass = 0;
+
+    Q_FOREACH(OGBall * ball, component)
+    {
+        if (!ball->IsAttached() || ball->IsDragging() || ball->IsClimbing()
+                || ball->IsMarked() || ball->isExit())
+        {
+            return false;
+        }
+
+        OGUserData* data = ball->GetUserData();
+
+        if (!data || data->isAttachedOnEnter) return false;
+
+        b2Body* body = ball->body;
+        float v = body->GetLinearVelocity().LengthSquared();
+        float w = body->GetAngularVelocity();
+
+        energy += 0.5f * (body->GetMass() * v + body->GetInertia() * w * w);
+        mass += body->GetMass();
+        bodies << body;
+    }
+
+    if (mass <= 0 || energy / mass > ENERGY_THRESHOLD) return false;
+
+    // Something moving against the structure would thaw it right away
+    Q_FOREACH(b2Body * body, bodies)
+    {
+        for (b2ContactEdge* e = body->GetContactList(); e; e = e->next)
+        {
+            b2Contact* c = e->contact;
+
+            if (!c->IsTouching() || c->GetFixtureA()->IsSensor()
+                    || c->GetFixtureB()->IsSensor())
+            {
+                continue;
+            }
+
+            if (IsMoving(e->other) && !bodies.contains(e->other))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+void OGStructureFreezer::_Freeze(const QList<OGBall*> &component)
+{
+    float mass = 0;
+    b2Vec2 center(0, 0);
+    b2Vec2 velocity(0, 0);
+
+    Q_FOREACH(OGBall * ball, component)
+    {
+        float m = ball->body->GetMass();
+        mass += m;
+        center += m * ball->body->GetWorldCenter();
+        velocity += m * ball->body->GetLinearVelocity();
+    }
+
+    center *= 1.0f / mass;
+    velocity *= 1.0f / mass;
+
+    b2BodyDef def;
+    def.type = b2_dynamicBody;
+    def.position = center;
+    def.linearVelocity = velocity;
+
+    Structure* structure = new Structure;
+    structure->body = PEngine::GetInstance()->CreateBody(def);
+
+    const b2Transform &xf = structure->body->GetTransform();
+    float inertia = 0;
+
+    Q_FOREACH(OGBall * ball, component)
+    {
+        b2Body* body = ball->body;
+        b2Transform pose = b2MulT(xf, body->GetTransform());
+
+        for (b2Fixture* f = body->GetFixtureList(); f; f = f->GetNext())
+        {
+            if (!f->IsSensor()) CreateFixture(structure->body, f, pose);
+        }
+
+        // Inertia of the ball about its center, moved to the center of
+        // the structure
+        float m = body->GetMass();
+        b2Vec2 lc = body->GetLocalCenter();
+        b2Vec2 d = body->GetWorldCenter() - center;
+        inertia += body->GetInertia() - m * b2Dot(lc, lc) + m * b2Dot(d, d);
+
+        body->SetActive(false);
+        ball->SetFrozen(true);
+
+        structure->balls << ball;
+        structure->poses << pose;
+        frozen_.insert(ball, structure);
+        quietSteps_.remove(ball);
+    }
+
+    // The fixtures carry no density, so the structure weighs what
+    // its balls weigh, including the tower mass of the climbers
+    b2MassData massData;
+    massData.mass = mass;
+    massData.center.SetZero();
+    massData.I = inertia;
+    structure->body->SetMassData(&massData);
+
+    structures_ << structure;
+
+    logDebugf("Froze a structure of %1 balls", component.size());
+
+    _UpdateMetrics();
+}
+
+void OGStructureFreezer::_Thaw(Structure* structure)
+{
+    b2Body* compound = structure->body;
+
+    _Sync(structure);
+
+    for (int i = 0; i < structure->balls.size(); i++)
+    {
+        OGBall* ball = structure->balls.at(i);
+        b2Body* body = ball->body;
+
+        body->SetActive(true);
+        body->SetLinearVelocity(
+            compound->GetLinearVelocityFromWorldPoint(body->GetWorldCenter()));
+        body->SetAngularVelocity(compound->GetAngularVelocity());
+        body->SetAwake(true);
+
+        ball->SetFrozen(false);
+        frozen_.remove(ball);
+    }
+
+    PEngine::GetInstance()->DestroyBody(compound);
+
+    structures_.removeOne(structure);
+
+    logDebugf("Thawed a structure of %1 balls", structure->balls.size());
+
+    delete structure;
+
+    _UpdateMetrics();
+}
+
+void OGStructureFreezer::_Sync(Structure* structure)
+{
+    const b2Transform &xf = structure->body->GetTransform();
+
+    for (int i = 0; i < structure->balls.size(); i++)
+    {
+        b2Transform pose = b2Mul(xf, structure->poses.at(i));
+        structure->balls.at(i)->body->SetTransform(pose.p, pose.q.GetAngle());
+    }
+}
+
+bool OGStructureFreezer::_IsTouched(Structure* structure) const
+{
+    for (b2ContactEdge* e = structure->body->GetContactList(); e; e = e->next)
+    {
+        b2Contact* c = e->contact;
+
+        if (!c->IsTouching()) continue;
+
+        // The exit counts the balls by their own bodies
+        if (IsExit(c->GetFixtureA()) || IsExit(c->GetFixtureB())) return true;
+
+        if (c->GetFixtureA()->IsSensor() || c->GetFixtureB()->IsSensor())
+            continue;
+
+        if (IsMoving(e->other)) return true;
+    }
+
+    return false;
+}
+
+void OGStructureFreezer::_UpdateMetrics()
+{
+    static Metrics::Gauge* structures = Metrics::GetGauge("physics.frozen_structures");
+    static Metrics::Gauge* balls = Metrics::GetGauge("physics.frozen_balls");
+
+    structures->Set(structures_.size());
+    balls->Set(frozen_.size());
+}
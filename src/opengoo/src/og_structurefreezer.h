@@ -0,0 +1,69 @@
+#ifndef OG_STRUCTUREFREEZER_H
+#define OG_STRUCTUREFREEZER_H
+
+#include <QHash>
+#include <QList>
+
+class OGBall;
+
+// A finished tower never sleeps: its springs keep the island awake and the
+// solver pays for every ball and strand on each step. When all the balls
+// connected by strands stay still for SETTLE_STEPS steps, the component is
+// frozen: the ball bodies are deactivated (their joints stay, but aren't
+// solved) and one compound body with a fixture per ball takes their place.
+// The balls follow the compound body while it's awake.
+//
+// A structure thaws back to the ball bodies and strands when one of its
+// balls is dragged, attached to or detached from, or when a moving dynamic
+// body touches it. The exit counts the balls by their own bodies, so
+// structures touching it aren't frozen, and a frozen one which reaches
+// it thaws.
+class OGStructureFreezer
+{
+    public:
+        enum
+        {
+            CHECK_STEPS = 10,  // the components are measured every 10 steps
+            SETTLE_STEPS = 120 // 2 seconds
+        };
+
+        OGStructureFreezer();
+        ~OGStructureFreezer();
+
+        // Forgets the structures and the bodies of the level,
+        // they are destroyed with the physics world
+        void Clear();
+
+        // Called after every physics step
+        void Update(const QList<OGBall*> &balls);
+
+        // Thaws the structure of the ball, if it's frozen
+        void Thaw(OGBall* ball);
+
+        int Count() const { return structures_.size(); }
+
+    private:
+        struct Structure;
+
+        QList<Structure*> structures_;
+        QHash<OGBall*, Structure*> frozen_;
+        QHash<OGBall*, int> quietSteps_;
+        int step_;
+
+        OGStructureFreezer(const OGStructureFreezer&);
+        OGStructureFreezer& operator=(const OGStructureFreezer&);
+
+        void _FindSettled(const QList<OGBall*> &balls);
+        bool _CollectComponent(OGBall* ball, QList<OGBall*>* component
+                               , QHash<OGBall*, bool>* visited) const;
+        bool _IsQuiet(const QList<OGBall*> &component) const;
+
+        void _Freeze(const QList<OGBall*> &component);
+        void _Thaw(Structure* structure);
+        void _Sync(Structure* structure);
+        bool _IsTouched(Structure* structure) const;
+
+        void _UpdateMetrics();
+};
+
+#endif // OG_STRUCTUREFREEZER_H
@@ -4,6 +4,7 @@
 #include "opengoo.h"
 #include "wog_text.h"
 #include "og_sprite.h"
+#include "textrenderer.h"
 
 #include <QImage>
 #include <QString>
@@ -102,15 +103,11 @@ void OGUIButton::Paint(QPainter* painter)
 
 
 
-    QPen pen(Qt::white,  2.0f);
-    painter->setOpacity(1.0f);
-    painter->save();
-
-    painter->setPen(pen);
-    painter->setFont(QFont("Arial", 14, QFont::Bold));
-    painter->drawText(*this, Qt::AlignCenter, pImpl_->text);
+    static const QFont font("Arial", 14, QFont::Bold);
 
-    painter->restore();
+    painter->setOpacity(1.0f);
+    TextRenderer::Draw(painter, *this, Qt::AlignCenter, pImpl_->text, font
+                       , Qt::white);
 }
 
 void OGUIButton::MouseDown(QMouseEvent* ev)
@@ -1,8 +1,10 @@
 #ifndef OG_USERDATA_H
 #define OG_USERDATA_H
 #include "og_strand.h"
+#include "GameEngine/memorytracker.h"
 
-struct OGUserData
+// Owned by the object in data: the ball, the strand or the static body
+struct OGUserData : og::Tracked<OGUserData, og::MemoryTracker::PHYSICS>
 {
     enum Type {GEOM, BALL, STRAND};
 
@@ -14,9 +14,8 @@
 #include "og_world.h"
 #include "wog_resources.h"
 #include "wog_text.h"
-
-
-#include <QFile>
+#include "uiregistry.h"
+#include "GameEngine/texturecache.h"
 
 void ogUtils::ogBackTracer()
 {
@@ -46,6 +45,7 @@ void ogUtils::ogMessageHandler(QtMsgType type, const QMessageLogContext &context
             fprintf(stderr, "Critical: %s (%s:%u, %s)\n", localMsg.constData(), context.file, context.line, context.function);
             break;
         case QtFatalMsg:
+            LoggerEngine::flush();
             fprintf(stderr, "Fatal: %s (%s:%u, %s)\n", localMsg.constData(), context.file, context.line, context.function);
             abort();
     }
@@ -63,6 +63,7 @@ void ogUtils::ogLogger()
                                    LoggerEngine::LevelException |
                                    LoggerEngine::LevelFatal, stdout, "%d - <%l> - %m [%f:%i]%n");
     LoggerEngine::addAppender(con_apd);
+    LoggerEngine::startAsync();
     qInstallMessageHandler(ogMessageHandler);
 }
 
@@ -105,9 +106,15 @@ OGUserData* ogUtils::ogGetUserData(void* userdata)
 QPixmap* ogUtils::getImage(const QString & id)
 {
     OGWorld* world = OpenGOO::instance()->GetWorld();
-    WOGResources* resrc = world->resrcdata();
 
-    return new QPixmap(resrc->GetImage(id));
+    return getImage(id, *world->resrcdata());
+}
+
+// The pixels are decoded once and shared by all the copies
+QPixmap* ogUtils::getImage(const QString & id, const WOGResources & resrc)
+{
+    return new QPixmap(og::TextureCache::LoadPixmap(resrc.GetImage(id)
+                                                    + ".png"));
 }
 
 QString ogUtils::getText(const QString & id)
@@ -118,41 +125,9 @@ QString ogUtils::getText(const QString & id)
     return text->GetString(id);
 }
 
-std::unique_ptr<UIData> ogUtils::getUIData(const QString & id)
-{    
-    QFile file(":/ui/resources.xml");
-    file.open(QIODevice::ReadOnly);
-
-    QDomDocument domDoc;
-    std::unique_ptr<UIData> data;
-
-    if (domDoc.setContent(&file))
-    {
-        QDomElement rootElement = domDoc.documentElement();
-        QDomNode node = rootElement.firstChild();
-        QDomElement element;
-        bool isFound = false;
-
-        while (!node.isNull() && !isFound)
-        {
-            element = node.toElement();
-
-            if (element.attribute("id") == id) isFound = true;
-            else node = node.nextSibling();
-        }
-
-        if (isFound)
-        {
-            data.reset(new UIData);
-            data->width = element.attribute("width").toInt();
-            data->height = element.attribute("height").toInt();
-            data->up = element.attribute("up");
-            data->over = element.attribute("over");
-            data->text = element.attribute("text");
-        }
-    }
-
-    return data;
+const UIData* ogUtils::getUIData(const QString & id)
+{
+    return UIRegistry::Get(id);
 }
 
 template<class T> T* ogUtils::createUI(const QPoint & pos, const UIData & data)
@@ -13,6 +13,8 @@
 
 struct OGUserData;
 
+class WOGResources;
+
 class OGContactListener;
 
 namespace ogUtils
@@ -32,11 +34,13 @@ OGUserData* ogGetUserData(void* userdata);
 OGContactListener* ogGetContactListener();
 
 QPixmap* getImage(const QString & id);
+QPixmap* getImage(const QString & id, const WOGResources & resrc);
 QString getText(const QString &id);
 
 og::OGGameEngine* getGameEngine();
 
-std::unique_ptr<UIData> getUIData(const QString &id);
+// Returns 0 for an unknown id
+const UIData* getUIData(const QString &id);
 
 template<class T> T* createUI(const QPoint &pos, const UIData &data);
 og::ui::PushButton* createButton(const QPoint &pos, const UIData &data);
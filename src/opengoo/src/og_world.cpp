@@ -2,12 +2,13 @@
 
 #include <QPainter>
 #include <QFile>
-#include <QTimer>
+#include <QElapsedTimer>
 
 #include "og_world.h"
 #include "logger.h"
 #include "og_pipe.h"
 #include "og_data.h"
+#include "og_configcache.h"
 #include "og_circle.h"
 #include "exit.h"
 #include "og_rectangle.h"
@@ -15,8 +16,11 @@
 #include "og_ball.h"
 #include "og_button.h"
 #include "GameEngine/og_gameengine.h"
+#include "GameEngine/metrics.h"
+#include "GameEngine/textrenderer.h"
 #include "og_windowcamera.h"
 #include "og_strand.h"
+#include "og_scenelabel.h"
 #include "opengoo.h"
 #include "OGLib/rectf.h"
 
@@ -25,8 +29,26 @@
 
 using namespace og;
 
+namespace
+{
+const int DEFAULT_FONT_SIZE = 32; // in pixels, before the scale of a label
+}
+
+std::atomic<int> OGWorld::worldCount_(0);
+
+OGWorld::Scope::Scope(OGWorld* world)
+    : previous_(OGPhysicsEngine::SetCurrent(world->physics()))
+{
+}
+
+OGWorld::Scope::~Scope()
+{
+    OGPhysicsEngine::SetCurrent(previous_);
+}
+
 OGWorld::OGWorld(const QString &levelname, QObject* parent)
     : QObject(parent)
+    , physics_(new OGPhysicsEngine)
 {
     levelName_ = levelname;
 
@@ -38,22 +60,27 @@ OGWorld::OGWorld(const QString &levelname, QObject* parent)
     pTextData_[1] = 0;       // local text
     pMaterialData_ = 0;
     pEffectsData_ = 0;
-    pTimer_ = 0;
     pCamera_ = 0;
     pPipe_ = 0;
-    pNearestBall_ = 0;
     pPhysicsEngine_ = 0;
     pExit_ = 0;
 
     strandId_ = 0;
     ballId_ = 0;
 
+    levelUsage_ = MemoryTracker::GetUsage();
+
     isPhysicsEngine_ = false;
+    isHeadless_ = false;
     isLevelLoaded_ = false;
+
+    worldCount_++;
 }
 
 OGWorld::~OGWorld()
 {
+    Scope scope(this);
+
     _ClearLocalData(); // clear local data
 
     logInfo("Clear share data");
@@ -70,11 +97,10 @@ OGWorld::~OGWorld()
     if (pEffectsData_)
         delete pEffectsData_;
 
-    delete pTimer_;
-
     logInfo("Destroy physics engine");
 
-    OGPhysicsEngine::DestroyInstance();
+    physics_.reset();
+    worldCount_--;
 }
 
 bool OGWorld::isExist(const QString &path_level)
@@ -85,7 +111,7 @@ bool OGWorld::isExist(const QString &path_level)
 
     if (!QFile::exists(path + ".xml") && !QFile::exists(path + ".bin"))
     {
-        logDebug(QString("File %1 not found").arg(path));
+        logDebugf("File %1 not found", path);
         return false;
     }
 
@@ -93,7 +119,7 @@ bool OGWorld::isExist(const QString &path_level)
 
     if (!QFile::exists(path + ".xml") && !QFile::exists(path + ".bin"))
     {
-        logDebug(QString("File %1 not found").arg(path));
+        logDebugf("File %1 not found", path);
         return false;
     }
 
@@ -101,7 +127,7 @@ bool OGWorld::isExist(const QString &path_level)
 
     if (!QFile::exists(path + ".xml") && !QFile::exists(path + ".bin"))
     {
-        logDebug(QString("File %1 not found").arg(path));
+        logDebugf("File %1 not found", path);
         return false;
     }
 
@@ -110,6 +136,8 @@ bool OGWorld::isExist(const QString &path_level)
 
 bool OGWorld::Initialize()
 {
+    Scope scope(this);
+
     logInfo("Initializing the physics engine");
 
     if (!_InitializePhysics())
@@ -165,7 +193,7 @@ bool OGWorld::Load()
     }
     else
     {
-        logWarn(QString("Wrong level name: \"%1\"").arg(levelName_));
+        logWarnf("Wrong level name: \"%1\"", levelName_);
 
         return false;
     }
@@ -175,6 +203,8 @@ bool OGWorld::Load()
 
 void OGWorld::Reload()
 {
+    Scope scope(this);
+
     _ClearPhysics();
     CreatePhysicsScene();
 
@@ -185,12 +215,23 @@ void OGWorld::Reload()
 template<class Target, class Config>
 Target OGWorld::LoadConf(const QString &path)
 {
+    Target data;
+    OGConfigCache::Load(path, &data);
+
+    if (data)
+        return data;
+
     Config config(path);
 
     if (config.Open())
     {
         if (config.Read())
-            return config.Parser();
+        {
+            data = config.Parser();
+            OGConfigCache::Store(path, data);
+
+            return data;
+        }
         else
             logWarn("File " + path + " is corrupted");
     }
@@ -303,6 +344,14 @@ bool OGWorld::_LoadText(const QString &path, bool share)
     if (data)
         return false;
 
+    data = OGConfigCache::LoadText(path, language_);
+
+    if (data)
+    {
+        pTextData_[share ? 0 : 1] = data;
+        return true;
+    }
+
     OGTextConfig config(path);
 
     bool status = true;
@@ -312,6 +361,7 @@ bool OGWorld::_LoadText(const QString &path, bool share)
         if (config.Read())
         {
             data = config.Parser(language_);
+            OGConfigCache::Store(path, data, language_);
 
             if (!data)
                 status = false;
@@ -383,6 +433,20 @@ void OGWorld::CreateScene()
         _CreateSceneLayer(*sceneLayer, &sprites_);
     }
 
+    logInfo("Create labels");
+
+    Q_FOREACH(WOGLabel * label, scenedata()->label)
+    {
+        _CreateLabel(*label);
+    }
+
+    logInfo("Create particles");
+
+    Q_FOREACH(WOGParticle * particle, scenedata()->particle)
+    {
+        _CreateParticle(*particle);
+    }
+
     logInfo("Create buttongroups");
 
     Q_FOREACH(WOGButtonGroup * btnGroup, scenedata()->buttongroup)
@@ -419,12 +483,6 @@ void OGWorld::CreateScene()
         }
     }
 
-    if (leveldata()->levelexit != 0)
-    {
-        xExit_ = leveldata()->levelexit->pos.x() * 0.1;
-        yExit_ = leveldata()->levelexit->pos.y() * 0.1;
-    }
-
     CreatePhysicsScene();
 }
 
@@ -432,13 +490,20 @@ void OGWorld::CreatePhysicsScene()
 {
     logInfo("Creating physics");
 
-    pPhysicsEngine_ = OGPhysicsEngine::GetInstance();
+    pPhysicsEngine_ = physics_.get();
+    pPhysicsEngine_->AddContactObserver(&ground_);
+
+    if (leveldata()->levelexit != 0)
+    {
+        routes_.SetExit(leveldata()->levelexit->pos.x() * 0.1
+                        , leveldata()->levelexit->pos.y() * 0.1);
+    }
 
     if (!pExit_ && leveldata()->levelexit != 0)
     {
         logInfo("Creating exit");
 
-        pExit_ = new Exit(leveldata()->levelexit);
+        pExit_ = new Exit(leveldata()->levelexit, this);
     }
 
     Q_FOREACH(WOGCircle * circle, scenedata()->circle)
@@ -456,7 +521,7 @@ void OGWorld::CreatePhysicsScene()
     Q_FOREACH(WOGLine * line, scenedata()->line)
     {
         if (!line->dynamic)
-            staticBodies_ << _CreateBody<OGLine, WOGLine>(line);
+            staticBodies_ << _CreateBody<OGLine, WOGLine>(line, scenedata());
     }
 
     Q_FOREACH(WOGCompositeGeom *cg, scenedata()->compositegeom)
@@ -481,18 +546,35 @@ void OGWorld::CreatePhysicsScene()
 
     _SetGravity();
 
+    const WOGSolver &solver = leveldata()->solver;
+    OGSolverLimits limits;
+    limits.minVelocityIterations = solver.minvelocity;
+    limits.maxVelocityIterations = solver.maxvelocity;
+    limits.minPositionIterations = solver.minposition;
+    limits.maxPositionIterations = solver.maxposition;
+    limits.maxSubsteps = solver.maxsubsteps;
+    limits.budget = solver.budget;
+
+    pPhysicsEngine_->SetSolverLimits(limits);
     pPhysicsEngine_->SetSimulation(6, 2, 60);
 
-    pNearestBall_ = 0;
+    isLevelLoaded_ = true;    
+}
 
-    if (pTimer_ == 0)
+void OGWorld::_CreateParticle(const WOGParticle &particle)
+{
+    const WOGParticleEffect* effect = 0;
+
+    if (pEffectsData_) effect = pEffectsData_->GetEffect(particle.effect);
+
+    if (!effect)
     {
-        pTimer_ = new QTimer(this);
-        connect(pTimer_, SIGNAL(timeout()), this, SLOT(findNearestAttachedBall()));
-        pTimer_->start(1000);
+        logWarn("Unknown effect " + particle.effect);
+        return;
     }
 
-    isLevelLoaded_ = true;    
+    QPointF pos(particle.position.x(), -particle.position.y());
+    _GetGame()->AddParticles(effect, pos, particle.pretick);
 }
 
 void OGWorld::_CreateSceneLayer(const WOGSceneLayer &scenelayer
@@ -500,6 +582,26 @@ void OGWorld::_CreateSceneLayer(const WOGSceneLayer &scenelayer
 {
     OGSprite* sprite = _CreateSprite(&scenelayer, scenelayer.image);
     sprites->push_back(sprite);
+
+    if (!scenelayer.anim.isEmpty()
+            && _GetGame()->AddAnimation(sprite, scenelayer.anim
+                                        , scenelayer.animspeed))
+    {
+        animatedSprites_ << sprite;
+    }
+}
+
+void OGWorld::_CreateLabel(const WOGLabel &label)
+{
+    QString text = textdata() ? textdata()->GetString(label.text) : QString();
+
+    if (text.isEmpty())
+    {
+        logWarnf("Wrong text id: %1", label.text);
+        return;
+    }
+
+    labels_ << new OGSceneLabel(label, text, GetFont(label.font));
 }
 
 OGBall* OGWorld::_CreateBall(WOGBallInstance* ball)
@@ -510,24 +612,25 @@ OGBall* OGWorld::_CreateBall(WOGBallInstance* ball)
     if (configuration)
     {
         if (configuration->attribute.core.shape->type == "circle")
-            obj = new OGBall(ball, configuration);
+            obj = new OGBall(ball, configuration, this);
         else if (configuration->attribute.core.shape->type == "rectangle")
-            obj = new OGBall(ball, configuration);
+            obj = new OGBall(ball, configuration, this);
     }
 
     return obj;
 }
 
-template<class Body, class Data> Body* OGWorld::_CreateBody(Data* data)
+template<class Body, class Data, class... Args>
+Body* OGWorld::_CreateBody(Data* data, Args... args)
 {
     Body* obj = 0;
     QString id = data->material;
     WOGMaterial* material = materialdata()->GetMaterial(id);
 
     if (material)
-        obj = new Body(data, material);
+        obj = new Body(data, material, args...);
     else
-        logError(QString("Wrong material id: %1").arg(id));
+        logErrorf("Wrong material id: %1", id);
 
     return obj;
 }
@@ -562,6 +665,7 @@ void OGWorld::_CreateButton(const WOGButton &button,
     }
 
     buttons->push_back(btn);
+    buttonIndex_.Add(btn);
 }
 
 bool OGWorld::_CreateCamera()
@@ -600,7 +704,7 @@ void OGWorld::_CreatePipe()
     {
         logInfo("Create pipe");
 
-        pPipe_ = new OGPipe(pipe);
+        pPipe_ = new OGPipe(pipe, this);
     }
 }
 
@@ -611,6 +715,46 @@ ImageSourcePtr OGWorld::CreateImageSource(const QString& a_id)
     return std::make_shared<ImageSource>(file);
 }
 
+QString OGWorld::GetSoundPath(const QString &id) const
+{
+    QString path;
+
+    if (pResourcesData_[1])
+        path = pResourcesData_[1]->GetSound(id);
+
+    if (path.isEmpty() && pResourcesData_[0])
+        path = pResourcesData_[0]->GetSound(id);
+
+    return path;
+}
+
+QFont OGWorld::GetFont(const QString &id) const
+{
+    QString path;
+
+    if (pResourcesData_[1])
+        path = pResourcesData_[1]->GetFont(id);
+
+    if (path.isEmpty() && pResourcesData_[0])
+        path = pResourcesData_[0]->GetFont(id);
+
+    QString family;
+
+    if (!path.isEmpty())
+    {
+        family = TextRenderer::AddFont(path + ".ttf");
+
+        if (family.isEmpty())
+            family = TextRenderer::AddFont(path + ".otf");
+    }
+
+    QFont font(family.isEmpty() ? "Arial" : family);
+    font.setPixelSize(DEFAULT_FONT_SIZE);
+    font.setBold(family.isEmpty());
+
+    return font;
+}
+
 OGSprite* OGWorld::_CreateSprite(const WOGVObject* vobject
                                  , const QString &image)
 {
@@ -676,7 +820,7 @@ WOGBall* OGWorld::GetBallConfiguration(const QString &type)
 
 bool OGWorld::_InitializePhysics()
 {
-    return OGPhysicsEngine::GetInstance()->Initialize(0, -10, true);
+    return physics_->Initialize(0, -10, true);
 }
 
 void OGWorld::_SetGravity()
@@ -687,7 +831,7 @@ void OGWorld::_SetGravity()
         {
             float x = scenedata()->linearforcefield.last()->force.x();
             float y = scenedata()->linearforcefield.last()->force.y();
-            OGPhysicsEngine::GetInstance()->SetGravity(x, y);
+            physics_->SetGravity(x, y);
         }
     }
 }
@@ -695,7 +839,13 @@ void OGWorld::_SetGravity()
 
 void OGWorld::_ClearPhysics()
 {
+    // The balls are deleted below, their contacts end with their bodies
+    if (pPhysicsEngine_) pPhysicsEngine_->RemoveContactObserver(&ground_);
+
     pPhysicsEngine_ = 0;
+    ground_.Clear();
+    freezer_.Clear();
+    routes_.Clear();
 
     if (_forceFilds.size())
     {
@@ -713,12 +863,6 @@ void OGWorld::_ClearPhysics()
         delete i.value();
     }
 
-    if (pTimer_)
-    {
-        delete pTimer_;
-        pTimer_ = 0;
-    }
-
     strands_.clear();
 
     logInfo("Clear balls");
@@ -749,7 +893,7 @@ void OGWorld::_ClearPhysics()
     strandId_ = 0;
     ballId_ = 0;
 
-    OGPhysicsEngine::GetInstance()->Reload();
+    physics_->Reload();
 
     isLevelLoaded_ = false;
 }
@@ -762,12 +906,24 @@ void OGWorld::_ClearScene()
 
         while (!sprites_.isEmpty())
             delete sprites_.takeFirst();
+
+        animatedSprites_.clear();
+    }
+
+    if (!labels_.isEmpty())
+    {
+        logInfo("Clear labels");
+
+        while (!labels_.isEmpty())
+            delete labels_.takeFirst();
     }
 
     if (!buttons_.isEmpty())
     {
         logInfo("Clear buttons");
 
+        buttonIndex_.Clear();
+
         while (!buttons_.isEmpty())
             delete buttons_.takeFirst();
     }
@@ -789,8 +945,73 @@ void OGWorld::_ClearScene()
     }
 }
 
+namespace
+{
+class BallPicker : public b2QueryCallback
+{
+public:
+    BallPicker(const b2Vec2 &point, float radius)
+        : point_(point), radius_(radius), ball_(0), rank_(0), distance_(0)
+    {
+    }
+
+    bool ReportFixture(b2Fixture* fixture)
+    {
+        OGBall* ball = static_cast<OGBall*>(fixture->GetUserData());
+
+        if (!ball || ball == ball_) return true;
+
+        float distance = ball->GetPickDistance(point_);
+
+        if (distance > radius_) return true;
+
+        int rank = (ball->IsDraggable() && !ball->IsAttached()) ? 0 : 1;
+
+        if (!ball_ || rank < rank_ || (rank == rank_ && distance < distance_))
+        {
+            ball_ = ball;
+            rank_ = rank;
+            distance_ = distance;
+        }
+
+        return true;
+    }
+
+    OGBall* ball() const { return ball_; }
+
+private:
+    b2Vec2 point_;
+    float radius_;
+    OGBall* ball_;
+    int rank_;
+    float distance_;
+};
+}
+
+OGBall* OGWorld::PickBall(const QPoint &pos, float radius) const
+{
+    const float K = 0.1f;
+
+    if (!pPhysicsEngine_) return 0;
+
+    b2Vec2 point(pos.x() * K, pos.y() * K);
+    BallPicker picker(point, radius);
+
+    b2AABB aabb;
+    aabb.lowerBound = point - b2Vec2(radius, radius);
+    aabb.upperBound = point + b2Vec2(radius, radius);
+    pPhysicsEngine_->QueryAABB(&picker, aabb);
+
+    return picker.ball();
+}
+
 void OGWorld::CreateStrand(OGBall* b1, OGBall* b2)
 {
+    Scope scope(this);
+
+    freezer_.Thaw(b1);
+    freezer_.Thaw(b2);
+
     if (b1->id() == -1)
         b1->SetId(ballId_++);
 
@@ -800,56 +1021,63 @@ void OGWorld::CreateStrand(OGBall* b1, OGBall* b2)
     OGStrand* obj = new OGStrand(b1, b2, strandId_);
     strands_.insert(strandId_, obj);
     strandId_++;
+
+    if (obj->HasJoint()) routes_.AddStrand(b1, b2);
 }
 
-void OGWorld::findNearestAttachedBall()
+void OGWorld::Step(int steps, bool exit)
 {
-    if (leveldata()->levelexit == 0)
-        return;
-
-    qreal dx, dy, x2, y2, length, tmpLength;
-    bool isInit = false;
+    Scope scope(this);
 
     Q_FOREACH(OGBall * ball, balls_)
     {
-        if (ball->IsAttached())
+        ball->Update();
+    }
+
+    if (pExit_ && exit) pExit_->Update();
+
+    for (int i = 0; i < steps; i++)
+    {
+        for (unsigned int j = 0; j < _forceFilds.size(); j++)
         {
-            if (!isInit)
-            {
-                pNearestBall_ = ball;
-                x2 = pNearestBall_->GetX();
-                y2 = pNearestBall_->GetY();
-                dx = xExit_ - x2;
-                dy = yExit_ - y2;
-                length = dx * dx + dy * dy;
-                isInit = true;
-            }
-            else
-            {
-                x2 = ball->GetX();
-                y2 = ball->GetY();
-                dx = xExit_ - x2;
-                dy = yExit_ - y2;
-                tmpLength = dx * dx + dy * dy;
-
-                if (tmpLength < length)
-                {
-                    length = tmpLength;
-                    pNearestBall_ = ball;
-                }
-            }
+            _forceFilds[j]->update();
         }
+
+        Update();
     }
 }
 
 void OGWorld::Update()
 {
+    static Metrics::Gauge* balls = Metrics::GetGauge("world.balls");
+    static Metrics::Gauge* strands = Metrics::GetGauge("world.strands");
+    static Metrics::Gauge* bodies = Metrics::GetGauge("world.static_bodies");
+    static Metrics::Gauge* forcefields = Metrics::GetGauge("world.forcefields");
+
     if (pPhysicsEngine_)
+    {
         pPhysicsEngine_->Simulate();
+        freezer_.Update(balls_);
+    }
+
+    balls->Set(balls_.size());
+    strands->Set(strands_.size());
+    bodies->Set(staticBodies_.size());
+    forcefields->Set(_forceFilds.size());
 }
 
 bool OGWorld::LoadLevel(const QString &levelname)
 {
+    static Metrics::Histogram* loadTime = Metrics::GetHistogram("world.level_load_ms"
+            , QVector<qint64>() << 50 << 100 << 250 << 500 << 1000 << 2500 << 5000);
+    static Metrics::Counter* loaded = Metrics::GetCounter("world.levels_loaded");
+
+    Scope scope(this);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    levelUsage_ = MemoryTracker::GetUsage();
     SetLevelname(levelname);
 
     if (!Load())
@@ -864,16 +1092,46 @@ bool OGWorld::LoadLevel(const QString &levelname)
         return false;
     }
 
+    loadTime->Record(timer.elapsed());
+    loaded->Add();
+
     return true;
 }
 
+bool OGWorld::LoadPhysics(const QString &levelname)
+{
+    Scope scope(this);
+
+    isHeadless_ = true;
+    levelUsage_ = MemoryTracker::GetUsage();
+    SetLevelname(levelname);
+
+    if (!Load())
+        return false;
+
+    CreatePhysicsScene();
+
+    return isLevelLoaded();
+}
+
 void OGWorld::CloseLevel()
 {
+    Scope scope(this);
+
     logInfo("Close level");
 
     _ClearPhysics();
     _ClearScene();
     _ClearLocalData();
+
+    bool isClean = MemoryTracker::Report(levelUsage_
+                                         , "Memory after closing " + levelName_);
+
+    // The usage is counted for the process, it tells nothing
+    // while other worlds are loading or closing their levels
+    Q_ASSERT_X(isClean || worldCount_ > 1, "OGWorld::CloseLevel"
+               , "level-scoped objects leaked");
+    Q_UNUSED(isClean)
 }
 
 void OGWorld::_CreateZOrder()
@@ -901,6 +1159,8 @@ void OGWorld::_CreateZOrder()
 #else
     Q_FOREACH (OGSprite* sprite, sprites_)
     {
+        if (animatedSprites_.contains(sprite)) continue;
+
         _GetGame()->AddSprite(sprite->GetDepth(), sprite);
     }
 #endif
@@ -913,12 +1173,21 @@ void OGWorld::_InsertSprite(OGSprite* sprite)
 
 void OGWorld::RemoveStrand(OGStrand* strand)
 {
+    Scope scope(this);
+
+    freezer_.Thaw(strand->b1());
+    freezer_.Thaw(strand->b2());
+
+    if (strand->HasJoint()) routes_.RemoveStrand(strand->b1(), strand->b2());
+
     delete strands_.take(strand->id());
 }
 
-inline void  OGWorld::StartSearching()
+void OGWorld::ThawStructure(OGBall* ball)
 {
-    pTimer_->start(1000);
+    Scope scope(this);
+
+    freezer_.Thaw(ball);
 }
 
 inline WOGPipe* OGWorld::_GetPipeData()
@@ -1,10 +1,13 @@
 #pragma once
 
+#include <atomic>
 #include <memory>
 
 #include <QCache>
 #include <QHash>
 #include <QList>
+#include <QSet>
+#include <QFont>
 #include <QPainter>
 
 #include "wog_scene.h"
@@ -12,6 +15,10 @@
 #include <OGPhysicsEngine>
 #include "og_forcefield.h"
 #include "og_sprite.h"
+#include "og_buttonindex.h"
+#include "og_structurefreezer.h"
+#include "og_climbroutes.h"
+#include "og_groundcontacts.h"
 
 typedef std::unique_ptr<physics::OGForceField> ptr_ForceField;
 typedef std::unique_ptr<physics::OGRadialForceField> ptr_RForceField;
@@ -37,10 +44,16 @@ class OGBall;
 class OGButton;
 class OGStrand;
 class OGIBody;
+class OGSceneLabel;
 class OpenGOO;
 
-class QTimer;
-
+// A world owns everything a level needs while it's simulated: its physics
+// engine (the b2World and the contact listener), the balls, the strands and
+// the resources. The balls, the exit and the pipe are given their world,
+// the scene bodies their scene. The sensors, the strands and the physics
+// helpers reach the engine bound to the calling thread. The public entry
+// points bind the world's engine themselves, so several worlds loaded with
+// LoadPhysics() can be stepped on a thread pool, one thread per world.
 class OGWorld : public QObject
 {
         Q_OBJECT
@@ -54,26 +67,27 @@ class OGWorld : public QObject
 
         QCache<QString, WOGBall> ballConfigurations_;
 
-        OGBall* pNearestBall_;
-
         // Exit
         Exit* pExit_;
-        float xExit_;
-        float yExit_;
-
-        QTimer* pTimer_;
 
         QString levelName_;
         QString language_;
         bool isLevelLoaded_;
+        og::MemoryTracker::Usage levelUsage_; // at the start of LoadLevel
 
         QList<OGButton*> buttons_;
+        OGButtonIndex buttonIndex_;
 
         QList<OGSprite*> sprites_;
+        QList<OGSceneLabel*> labels_;
+        QSet<OGSprite*> animatedSprites_; // painted out of the layers
         void _InsertSprite(OGSprite* sprite);
 
         QList<OGBall*> balls_;
         QHash<int, OGStrand*> strands_;
+        OGStructureFreezer freezer_;
+        OGClimbRoutes routes_;
+        OGGroundContacts ground_;
         QList<OGIBody*> staticBodies_;
         std::vector<ptr_ForceField> _forceFilds;
 
@@ -97,7 +111,7 @@ class OGWorld : public QObject
 
         // scene
         ptr_RForceField _CreateRadialForcefield(WOGRadialForceField* ff);
-        void _CreateParticle();
+        void _CreateParticle(const WOGParticle &particle);
         void _CreateSceneLayer(const WOGSceneLayer &scenelayer
                                , QList<OGSprite*>* sprites);
 
@@ -112,15 +126,18 @@ class OGWorld : public QObject
         WOGPipe* _GetPipeData();
         void _CreatePipe();
 
-        template<class Body, class Data> Body* _CreateBody(Data* data);
+        template<class Body, class Data, class... Args>
+        Body* _CreateBody(Data* data, Args... args);
 
-        void _CreateLabel();
+        void _CreateLabel(const WOGLabel &label);
 
         class OGWindowCamera* pCamera_;
         bool _CreateCamera();
 
         bool isPhysicsEngine_;
-        og::OGPhysicsEngine* pPhysicsEngine_;
+        bool isHeadless_;
+        std::unique_ptr<og::OGPhysicsEngine> physics_;
+        og::OGPhysicsEngine* pPhysicsEngine_; // set while a level is loaded
 
         void CreatePhysicsScene();
         bool _InitializePhysics();
@@ -134,7 +151,25 @@ class OGWorld : public QObject
 
         OpenGOO* _GetGame();
 
+        void Update();
+
+        static std::atomic<int> worldCount_;
+
     public:
+        // Binds the world's physics engine to the calling thread
+        // for the lifetime of the scope
+        class Scope
+        {
+            public:
+                explicit Scope(OGWorld* world);
+                ~Scope();
+
+            private:
+                og::OGPhysicsEngine* previous_;
+
+                Q_DISABLE_COPY(Scope)
+        };
+
         OGWorld(const QString &levelname = QString(), QObject* parent = 0);
         virtual ~OGWorld();
 
@@ -144,6 +179,7 @@ class OGWorld : public QObject
         const QList<OGBall*>& balls() const { return balls_; }
         const QList<OGButton*>& buttons() const { return buttons_; }
         const QList<OGSprite*>& sprites() const { return sprites_; }
+        const QList<OGSceneLabel*>& labels() const { return labels_; }
         const QHash<int, OGStrand*>& strands() const { return strands_; }
         QList<OGIBody*>& staticbodies() { return staticBodies_; }
         const QString &language() const { return language_; }
@@ -151,14 +187,29 @@ class OGWorld : public QObject
         WOGMaterialList* materialdata() { return pMaterialData_; }
         const QString &levelname() const { return levelName_; }
         WOGScene* scenedata() const { return pSceneData_; }
-        OGBall* nearestball() { return pNearestBall_; }
+        // The attached ball nearest to the exit, the climbers' goal
+        OGBall* nearestball() { return routes_.Goal(); }
+        OGClimbRoutes* climbroutes() { return &routes_; }
         WOGText* textdata() { return pTextData_[0]; }
         WOGResources* resrcdata() const { return pResourcesData_[0]; }
         OGIPipe* pipe() const { return pPipe_; }
         Exit* exit() const { return pExit_; }
         const std::vector<ptr_ForceField> &forcefilds() const { return _forceFilds; }
 
+        WOGEffects* effectsdata() const { return pEffectsData_; }
+
         bool isLevelLoaded() const { return isLevelLoaded_; }
+        // A headless world has no scene, sprites or sounds
+        bool isHeadless() const { return isHeadless_; }
+        og::OGPhysicsEngine* physics() const { return physics_.get(); }
+
+        // Picks the ball under the point (in logical pixels) with one
+        // broadphase query. Balls within the radius (in physics units)
+        // count as well; a free draggable ball wins over an attached one,
+        // then the nearest ball wins.
+        OGBall* PickBall(const QPoint &pos, float radius) const;
+
+        OGButton* FindButton(const QPoint &pos) const { return buttonIndex_.Find(pos); }
 
 
         // Set properties
@@ -172,22 +223,43 @@ class OGWorld : public QObject
         bool Initialize();
         bool Load();
         bool LoadLevel(const QString &levelname);
+        // Loads only the level's bodies, balls and strands and makes
+        // the world headless, e.g. for validating levels in batch
+        bool LoadPhysics(const QString &levelname);
         void Reload();
         void CloseLevel();
 
-        void Update();
+        // Advances the balls, the exit (if exit is set), the force fields
+        // and the physics by the given number of fixed steps
+        void Step(int steps, bool exit = true);
+
+        // The exit sensor reports the attached balls reaching it.
+        // The signals may be emitted from the simulation thread.
+        void OpenPipe() { emit pipeOpened(); }
+        void ClosePipe() { emit pipeClosed(); }
 
         template<class Target, class Config>
         Target LoadConf(const QString &path);
 
+        // Both thaw the structures of the balls
         void CreateStrand(OGBall* b1, OGBall* b2);
         void RemoveStrand(OGStrand* strand);
 
+        // Must be called before the ball is dragged
+        void ThawStructure(OGBall* ball);
+
         ImageSourcePtr CreateImageSource(const QString& a_id);
+        QString GetSoundPath(const QString &id) const;
+        // A font resource is used if its path has a .ttf or .otf file
+        QFont GetFont(const QString &id) const;
+
+        // Called by the simulation about once a second, the structure moves
+        // and another ball may get nearer to the exit
+        void findNearestAttachedBall() { routes_.UpdateGoal(); }
 
-        void StartSearching();
         friend class OGPipe;        
 
-    private slots:
-        void findNearestAttachedBall();
+    signals:
+        void pipeOpened();
+        void pipeClosed();
 };
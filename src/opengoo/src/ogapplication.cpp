@@ -1,9 +1,14 @@
 #include "ogapplication.h"
 #include "GameEngine/og_gameengine.h"
+#include "GameEngine/texturecache.h"
+#include "GameEngine/metrics.h"
+#include "og_configcache.h"
+#include "og_levelvalidator.h"
 #include "opengoo.h"
 
 #include "flags.h"
 #include "og_utils.h"
+#include "uiregistry.h"
 
 #include <QDir>
 #include <QApplication>
@@ -22,7 +27,7 @@ int OGApplication::run(int argc, char **argv)
 
     clear();
 
-    return 0;
+    return exitCode_;
 }
 
 bool OGApplication::initialize(int argc, char **argv)
@@ -36,8 +41,12 @@ bool OGApplication::initialize(int argc, char **argv)
     ogUtils::ogBackTracer();
     ogUtils::ogLogger();
 
+    const int VALIDATE_SECONDS = 30;
+
     QString levelName;
     bool isCrt = false;
+    bool isQuiet = false;
+    bool isValidate = false;
 
     //Check for the run parameters
     for (int i = 1; i < argc; i++)
@@ -53,6 +62,10 @@ bool OGApplication::initialize(int argc, char **argv)
         {
             flag |= FPS;
         }
+        if (!arg.compare("--quiet", Qt::CaseInsensitive))
+        {
+            isQuiet = true;
+        }
         if (!arg.compare("--crt", Qt::CaseInsensitive))
         {
             isCrt = true;
@@ -64,8 +77,16 @@ bool OGApplication::initialize(int argc, char **argv)
                 levelName = QString(argv[i]);
             }
         }
+        else if (!arg.compare("--validate", Qt::CaseInsensitive))
+        {
+            isValidate = true;
+        }
     }
 
+    // With --quiet the debug messages aren't even built
+    if (isQuiet)
+        LoggerEngine::setLevelFilter(LoggerEngine::LevelAll & ~LoggerEngine::LevelDebug);
+
     //CHECK FOR GAME DIR IN HOME DIRECTORY
     QDir dir;
     //If the game dir doesn't exist create it
@@ -81,6 +102,14 @@ bool OGApplication::initialize(int argc, char **argv)
     }
     else if (flag & DEBUG) logWarn("Game dir exist!");
 
+    og::TextureCache::SetDirectory(GAMEDIR + "/cache/textures");
+    OGConfigCache::SetDirectory(GAMEDIR + "/cache/config");
+    UIRegistry::Load();
+
+    // kill -USR1 <pid> writes the metrics, as does F12 in the game
+    Metrics::SetDirectory(GAMEDIR + "/debug");
+    Metrics::InstallSignalHandler();
+
     if (!dir.exists(RESOURCES_DIR))
     {
         logError(RESOURCES_DIR + " directory not found");
@@ -93,6 +122,17 @@ bool OGApplication::initialize(int argc, char **argv)
         return false;
     }
 
+    // Checks the levels (or the one given with --level) without
+    // starting the game
+    if (isValidate)
+    {
+        QStringList levels = levelName.isEmpty() ? OGLevelValidator::Levels()
+                                                 : QStringList(levelName);
+        exitCode_ = OGLevelValidator::Run(levels, VALIDATE_SECONDS) ? 1 : 0;
+
+        return false;
+    }
+
     OGConfig config;
     auto isLoaded = ogUtils::ogLoadConfig(config, PROPERTIES_DIR + "/" + FILE_CONFIG);
     if (!isLoaded)
@@ -102,16 +142,16 @@ bool OGApplication::initialize(int argc, char **argv)
         config.screen_width = 800;
         config.screen_height = 600;
         config.refreshrate = 60;
+        config.framepacing = "vsync";
+        config.maxframesteps = 4;
         config.language = "en";
 
         logInfo("Saving config file...");
         ogUtils::ogSaveConfig(config, PROPERTIES_DIR + "/" + FILE_CONFIG);
     }
 
-    int refreshrate = config.refreshrate;
-
-    if (refreshrate == 0)
-        refreshrate = FRAMERATE;
+    if (config.refreshrate <= 0)
+        config.refreshrate = FRAMERATE;
 
     auto game = OpenGOO::instance();
     game->SetLevelName(levelName);
@@ -127,4 +167,5 @@ void OGApplication::clear()
 {
     OpenGOO::instance()->Destroy();
     delete OGGameEngine::getInstance();
+    LoggerEngine::stopAsync();
 }
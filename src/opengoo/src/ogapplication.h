@@ -4,9 +4,13 @@
 class OGApplication
 {
 public:   
+    OGApplication() : exitCode_(0) {}
+
     int run(int argc, char** argv);
 
 private:
+    int exitCode_;
+
     bool initialize(int argc, char** argv);
     void clear();
 };
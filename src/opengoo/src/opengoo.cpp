@@ -13,14 +13,19 @@
     along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <QKeyEvent>
 #include <QMouseEvent>
+#include <QMutexLocker>
 #include <QTime>
 #include <QDebug>
 
+#include <limits>
+
 #include "opengoo.h"
 #include "og_world.h"
 #include "flags.h"
 #include "GameEngine/og_gameengine.h"
+#include "GameEngine/metrics.h"
 #include <logger.h>
 #include "og_windowcamera.h"
 #include "og_ballconfig.h"
@@ -28,15 +33,22 @@
 #include "og_sprite.h"
 #include "og_ibody.h"
 #include "og_strand.h"
+#include "og_scenelabel.h"
 #include "og_button.h"
 #include "og_pipe.h"
 #include "exit.h"
 #include "continuebutton.h"
 #include "og_fpscounter.h"
 #include "og_forcefield.h"
+#include "SoundEngine/og_soundengine.h"
 
 using namespace og;
 
+namespace
+{
+const float PICK_RADIUS = 0.5f; // in physics units
+}
+
 OpenGOO* OpenGOO::pInstance_ = nullptr;
 
 OpenGOO* OpenGOO::instance()
@@ -66,6 +78,22 @@ void OpenGOO::AddSprite(float depth, OGSprite* sprite)
     }
 }
 
+void OpenGOO::AddParticles(const WOGParticleEffect* effect, const QPointF &pos
+                           , float pretick)
+{
+    particles_.AddEmitter(effect, pos, pretick);
+}
+
+bool OpenGOO::AddAnimation(OGSprite* sprite, const QString &name, float speed)
+{
+    if (!animations_.Add(sprite, name, speed)) return false;
+
+    // The depth ranges of the caches have changed
+    sceneCaches_.clear();
+
+    return true;
+}
+
 void OpenGOO::AddSprite(OGSprite* sprite)
 {
     AddSprite(sprite->GetDepth(), sprite);
@@ -83,44 +111,63 @@ void OpenGOO::SetLevelName(const QString &levelname)
     levelName_ = levelname;
 }
 
-void OpenGOO::OpenPipe()
+// The exit sensor opens and closes the pipe on the simulation thread,
+// but the caps are scene sprites, which belong to the GUI thread
+void OpenGOO::ShowProgress()
 {
-    pWorld_->pipe()->Open();
-}
+    pContinueBtn_.reset();
 
-void OpenGOO::ClosePipe()
-{
-    pWorld_->pipe()->Close();
+    {
+        QMutexLocker locker(pSimulation_->mutex());
+        pWorld_->exit()->Close();
+    }
+
+    _InitProgressWindow();
 }
 
-void OpenGOO::ShowProgress()
+void OpenGOO::SetPause(bool pause)
 {
-    pContinueBtn_.reset();
-    pWorld_->exit()->Close();
-    _InitProgressWindow();
+    _pause = pause;
+
+    if (pSimulation_) pSimulation_->SetPaused(pause);
 }
 
 void OpenGOO::SetLanguage(const QString &language) { language_ = language; }
 
 void OpenGOO::_Start()
 {
-    const int STEPS = 60;
     pCamera_ = 0;
     pGameTime_ = 0;
     _ClearSelectedBall();
+    _pHoverButton = 0;
     _pFPS = 0;
+    pSimulation_.reset(new OGSimulation(this));
+    pSimulation_->SetMaxSteps(GE->getMaxFrameSteps());
+    searchTime_ = 0;
     SetPause(false);
 
     //initialize randseed
     qsrand(QTime::currentTime().toString("hhmmsszzz").toUInt());
 
+    logInfo("Initializing the sound engine");
+
+    if (!OGSoundEngine::GetInstance()->Initialize())
+        logWarn("Sound effects are disabled");
+
     pWorld_ = new OGWorld;
 
+    connect(pWorld_, SIGNAL(pipeOpened()), this, SLOT(_openPipe())
+            , Qt::QueuedConnection);
+    connect(pWorld_, SIGNAL(pipeClosed()), this, SLOT(_closePipe())
+            , Qt::QueuedConnection);
+
     if (language_.isEmpty()) pWorld_->SetLanguage("en");
     else pWorld_->SetLanguage(language_);
 
     if (!pWorld_->Initialize()) { return; }
 
+    particles_.SetResources(pWorld_->resrcdata());
+
     if (levelName_.isEmpty() || (!OGWorld::isExist(levelName_)))
     {
         _LoadMainMenu();
@@ -129,18 +176,18 @@ void OpenGOO::_Start()
 
     if (flag & FPS)
     {
-        _pFPS.reset(new OGFPSCounter(QRect(20, 20, 40, 40)));
+        _pFPS.reset(new OGFPSCounter(QRect(20, 20, 240, 150)));
     }
 
     width_ = OGGameEngine::getInstance()->getWidth();
     height_ = OGGameEngine::getInstance()->getHeight();
 
     timeScrollStep_ = width_ / 1000.0f;
-    timeStep_ = STEPS / 1000.0f;    
 }
 
 void OpenGOO::_End()
 {
+    pSimulation_->Stop();
     _pFPS.reset();
     pContinueBtn_.reset();
     pProgressWnd_.reset();
@@ -154,6 +201,9 @@ void OpenGOO::_End()
         logDebug("Clear world");
         delete pWorld_;
     }
+
+    pSimulation_.reset();
+    OGSoundEngine::DestroyInstance();
 }
 
 void OpenGOO::_Activate() { SetPause(false); }
@@ -161,6 +211,8 @@ void OpenGOO::_Deactivate() { SetPause(true); }
 
 void OpenGOO::_Cycle()
 {
+    Metrics::DumpIfRequested();
+
     if (!pWorld_->isLevelLoaded())
     {
         _Quit();
@@ -168,6 +220,12 @@ void OpenGOO::_Cycle()
         return;
     }
 
+    OGFrameScheduler &scheduler = GE->getWindow()->frameScheduler();
+
+    // The snapshot is taken once, _Paint draws the same step
+    if (pSimulation_->NextFrame())
+        scheduler.inputConsumed(pSimulation_->Snapshot().inputTime);
+
     if (!pGameTime_)
     {
         lastTime_ = 0;
@@ -176,7 +234,11 @@ void OpenGOO::_Cycle()
     }
     else lastTime_ = pGameTime_->restart();
 
-    if (flag & FPS) _pFPS->Update(lastTime_);
+    if (flag & FPS)
+    {
+        _pFPS->Update(lastTime_);
+        _pFPS->SetFrameTimes(scheduler.frameTimes());
+    }
 
     if (pCamera_)
     {
@@ -186,50 +248,134 @@ void OpenGOO::_Cycle()
 
     if (isPause()) return;
 
-    if (_pSelectedBall && !_pSelectedBall->IsDragging())
+    animations_.Update(lastTime_ / 1000.0f);
+
+    if (pCamera_)
+    {
+        particles_.UpdateBalls(pSimulation_->Snapshot().balls);
+        particles_.Update(lastTime_ / 1000.0f, pCamera_->rect());
+    }
+
+    if (isLevelExit_)
     {
-        if (!_pSelectedBall->TestPoint(lastMousePos_))
+        balls_ = pSimulation_->Snapshot().exitBalls;
+
+        if (balls_ >= ballsRequired_ && !isContinue_)
+        {
+            isContinue_ = true;
+            _CreateContinueButton();
+            pLevel_->hideButton();
+        }
+    }
+
+    OGSoundEngine::GetInstance()->Update();
+}
+
+void OpenGOO::SimInput(const OGInputEvent &ev)
+{
+    OGWorld::Scope scope(pWorld_);
+
+    switch (ev.type)
+    {
+    case OGInputEvent::MOUSE_DOWN:
+        if (_pSelectedBall && _pSelectedBall->IsDraggable())
+        {
+            pWorld_->ThawStructure(_pSelectedBall);
+            _pSelectedBall->MouseDown(ev.pos);
+        }
+        break;
+
+    case OGInputEvent::MOUSE_UP:
+        if (_pSelectedBall && _pSelectedBall->IsDragging())
+        {
+            _pSelectedBall->MouseUp(ev.pos);
+        }
+        break;
+
+    case OGInputEvent::MOUSE_MOVE:
+        lastMousePos_ = ev.pos;
+
+        if (!_pSelectedBall)
+        {
+            _pSelectedBall = pWorld_->PickBall(ev.pos, PICK_RADIUS);
+
+            if (_pSelectedBall) _pSelectedBall->SetMarked(true);
+        }
+        else if (_pSelectedBall->IsDragging())
+        {
+            _pSelectedBall->MouseMove(ev.pos);
+        }
+        else if (!_pSelectedBall->TestPoint(ev.pos, PICK_RADIUS))
         {
             _pSelectedBall->SetMarked(false);
             _ClearSelectedBall();
         }
+        break;
     }
+}
 
-    Q_FOREACH(OGBall * ball, pWorld_->balls())
+void OpenGOO::SimStep(int steps)
+{
+    const int SEARCH_TIME = 1000; // in milliseconds
+
+    if (_pSelectedBall && !_pSelectedBall->IsDragging())
     {
-        ball->Update();
+        if (!_pSelectedBall->TestPoint(lastMousePos_, PICK_RADIUS))
+        {
+            _pSelectedBall->SetMarked(false);
+            _ClearSelectedBall();
+        }
     }
 
-    if (pWorld_->exit() && !pProgressWnd_)
+    pWorld_->Step(steps, isExitActive_);
+
+    searchTime_ += qRound(steps * OGSimulation::StepTime());
+
+    if (searchTime_ >= SEARCH_TIME)
     {
-        pWorld_->exit()->Update();
+        searchTime_ = 0;
+        pWorld_->findNearestAttachedBall();
     }
+}
+
+void OpenGOO::SimSnapshot(OGRenderSnapshot* snapshot)
+{
+    int n = 0;
 
+    Q_FOREACH(OGBall * ball, pWorld_->balls())
     {
-        int n = (lastTime_ * timeStep_) + 0.5f; // round
+        if (ball->isExit()) continue;
 
-        for (int i = 0; i < n; i++)
-        {
-            for (unsigned int j=0; j < pWorld_->forcefilds().size(); j++)
-            {
-                pWorld_->forcefilds()[j]->update();
-            }
+        if (snapshot->balls.size() <= n) snapshot->balls.resize(n + 1);
 
-            pWorld_->Update();
-        }
+        ball->GetState(&snapshot->balls[n++]);
     }
 
-    if (isLevelExit_)
+    snapshot->balls.resize(n);
+
+    n = 0;
+
+    Q_FOREACH(OGStrand * strand, pWorld_->strands())
     {
-        balls_ = pWorld_->exit()->Balls();
+        if (!strand->b1() || !strand->b2()) continue;
 
-        if (balls_ >= ballsRequired_ && !isContinue_)
-        {
-            isContinue_ = true;
-            _CreateContinueButton();
-            pLevel_->hideButton();
-        }
+        if (snapshot->strands.size() <= n) snapshot->strands.resize(n + 1);
+
+        strand->GetState(&snapshot->strands[n++]);
     }
+
+    snapshot->strands.resize(n);
+
+    OGBall* nearest = pWorld_->nearestball();
+    snapshot->hasNearestBall = (nearest != 0);
+
+    if (nearest)
+    {
+        QPointF pos = nearest->GetPosition().toPointF();
+        snapshot->nearestBall = QPointF(pos.x() * 10, pos.y() * -10);
+    }
+
+    snapshot->exitBalls = pWorld_->exit() ? pWorld_->exit()->Balls() : 0;
 }
 
 void OpenGOO::_Paint(QPainter* painter)
@@ -238,35 +384,102 @@ void OpenGOO::_Paint(QPainter* painter)
     {
         painter->setWindow(pCamera_->rect());
 
+        QRectF view = pCamera_->rect();
+        renderStats_.Reset();
+
         // Paint a scene
-        QMutableMapIterator<float, OGLayer> i(layers_);
+        if (sceneCaches_.empty()) _CreateSceneCaches();
+
+        const QVector<float> &depths = animations_.Depths();
 
-        while (i.hasNext())
+        for (int i = 0; i < int(sceneCaches_.size()); i++)
         {
-            i.next();
-            i.value().Paint(painter);
+            sceneCaches_[i]->Paint(painter, &layers_, &renderStats_);
+
+            if (i < depths.size())
+                animations_.Paint(painter, view, depths.at(i), &renderStats_);
         }
 
+        Q_FOREACH(OGSceneLabel * label, pWorld_->labels())
+        {
+            if (!label->IsOverlay() && !label->IsScreenSpace())
+                label->Paint(painter);
+        }
+
+        // The particles of the scene are over all of its layers
+        particles_.Paint(painter, view, false, &renderStats_);
+
         Q_FOREACH(OGIBody * body, pWorld_->staticbodies())
         {
-            body->Draw(painter);
+            if (!view.intersects(body->GetBounds()))
+            {
+                renderStats_.culled++;
+                continue;
+            }
+
+            body->Draw(&batch_);
+            renderStats_.drawn++;
         }
 
-        Q_FOREACH(OGBall * ball, pWorld_->balls())
+        const OGRenderSnapshot &snapshot = pSimulation_->Snapshot();
+
+        Q_FOREACH(const OGBallState &ball, snapshot.balls)
         {
-            ball->Paint(painter, pWorld_->leveldata()->visualdebug);
+            if (!view.intersects(ball.bounds))
+            {
+                renderStats_.culled++;
+                continue;
+            }
+
+            OGBall::Paint(ball, &batch_);
+            renderStats_.drawn++;
         }
 
-        Q_FOREACH(OGStrand * strand, pWorld_->strands())
+        Q_FOREACH(const OGStrandState &strand, snapshot.strands)
         {
-            strand->Paint(painter, pWorld_->leveldata()->visualdebug);
+            if (!view.intersects(strand.bounds))
+            {
+                renderStats_.culled++;
+                continue;
+            }
+
+            OGStrand::Paint(strand, &batch_);
+            renderStats_.drawn++;
         }
 
+        if (_pFPS) _pFPS->SetRenderStats(renderStats_);
+
+        _UpdateRenderMetrics();
+
         if (pWorld_->leveldata() && pWorld_->leveldata()->visualdebug)
         {
-            visualDebug(painter, pWorld_, pCamera_->zoom());
+            visualDebug(&batch_, snapshot, pCamera_->zoom());
         }
+
+        batch_.Flush(painter);
+
+        particles_.Paint(painter, view, true, &renderStats_);
+
+        _PaintOverlayLabels(painter);
+    }
+}
+
+void OpenGOO::_PaintOverlayLabels(QPainter* painter)
+{
+    Q_FOREACH(OGSceneLabel * label, pWorld_->labels())
+    {
+        if (label->IsOverlay() && !label->IsScreenSpace()) label->Paint(painter);
     }
+
+    painter->save();
+    painter->setWindow(-width_ / 2, -height_ / 2, width_, height_);
+
+    Q_FOREACH(OGSceneLabel * label, pWorld_->labels())
+    {
+        if (label->IsScreenSpace()) label->Paint(painter);
+    }
+
+    painter->restore();
 }
 
 void OpenGOO::_MouseButtonDown(QMouseEvent* ev)
@@ -275,66 +488,58 @@ void OpenGOO::_MouseButtonDown(QMouseEvent* ev)
 
     QPoint mPos = pCamera_->windowToLogical(ev->pos());
 
-    Q_FOREACH(OGButton * button, pWorld_->buttons())
+    if (OGButton* button = pWorld_->FindButton(mPos))
     {
-        if (button->TestPoint(mPos))
+        if (button->onclick() == "quit") { _Quit(); }
+        else if (button->onclick() == "credits") { }
+        else if (button->onclick() == "showselectprofile") { }
+        else if (button->onclick() == "island1")
         {
-            if (button->onclick() == "quit") { _Quit(); }
-            else if (button->onclick() == "credits") { }
-            else if (button->onclick() == "showselectprofile") { }
-            else if (button->onclick() == "island1")
-            {
-                _SetIsland("island1"); // Saves the name of island
-                LoadIsland(_GetIsland());
-            }
-            else if (button->onclick() == "island2")
-            {
-                _SetIsland("island2"); // Saves the name of island
-                LoadIsland(_GetIsland());
-            }
-            else if (button->onclick() == "island3")
-            {
-                _SetIsland("island3"); // Saves the name of island
-                LoadIsland(_GetIsland());
-            }
-            else if (button->onclick() == "island4")
-            {
-                _SetIsland("island4"); // Saves the name of island
-                LoadIsland(_GetIsland());
-            }
-            else if (button->onclick() == "island5")
-            {
-                _SetIsland("island5"); // Saves the name of island
-                LoadIsland(_GetIsland());
-            }
-            else if (!button->onclick().isEmpty())
-            {
-                QString name = button->getLevelName();
+            _SetIsland("island1"); // Saves the name of island
+            LoadIsland(_GetIsland());
+        }
+        else if (button->onclick() == "island2")
+        {
+            _SetIsland("island2"); // Saves the name of island
+            LoadIsland(_GetIsland());
+        }
+        else if (button->onclick() == "island3")
+        {
+            _SetIsland("island3"); // Saves the name of island
+            LoadIsland(_GetIsland());
+        }
+        else if (button->onclick() == "island4")
+        {
+            _SetIsland("island4"); // Saves the name of island
+            LoadIsland(_GetIsland());
+        }
+        else if (button->onclick() == "island5")
+        {
+            _SetIsland("island5"); // Saves the name of island
+            LoadIsland(_GetIsland());
+        }
+        else if (!button->onclick().isEmpty())
+        {
+            QString name = button->getLevelName();
 
-                if (!name.isEmpty())
-                {
-                    loadLevel(name);
-                }
+            if (!name.isEmpty())
+            {
+                loadLevel(name);
             }
-
-            break;
         }
-    }    
-
-    if (_pSelectedBall && _pSelectedBall->IsDraggable())
-    {
-        _pSelectedBall->MouseDown(mPos);
     }
+
+    OGInputEvent input = {OGInputEvent::MOUSE_DOWN, mPos};
+    pSimulation_->PostInput(input);
 }
 
 void OpenGOO::_MouseButtonUp(QMouseEvent* ev)
 {
     if (isPause() || !pCamera_ || pProgressWnd_) return;
 
-    if (_pSelectedBall && _pSelectedBall->IsDragging() && pCamera_)
-    {
-        _pSelectedBall->MouseUp(pCamera_->windowToLogical(ev->pos()));
-    }
+    OGInputEvent input = {OGInputEvent::MOUSE_UP
+                          , pCamera_->windowToLogical(ev->pos())};
+    pSimulation_->PostInput(input);
 }
 
 void OpenGOO::_MouseMove(QMouseEvent* ev)
@@ -344,53 +549,90 @@ void OpenGOO::_MouseMove(QMouseEvent* ev)
     curMousePos_ = ev->pos();
 
     QPoint pos = pCamera_->windowToLogical(ev->pos());
-    lastMousePos_ = pos;
 
-    Q_FOREACH(OGButton * button, pWorld_->buttons())
-    {
-        if (button->TestPoint(pos))
-        {
-            button->up()->SetVisible(false);
-            button->over()->SetVisible(true);
-        }
-        else
-        {
-            button->up()->SetVisible(true);
-            button->over()->SetVisible(false);
-        }
-    }
+    _SetHoverButton(pWorld_->FindButton(pos));
 
-    if (!_pSelectedBall)
-    {
-        Q_FOREACH(OGBall * ball, pWorld_->balls())
-        {
-            if (ball->TestPoint(pos))
-            {
-                _pSelectedBall = ball;
-                _pSelectedBall->SetMarked(true);
-                break;
-            }
-        }
-    }
-    else if (_pSelectedBall->IsDragging())
+    OGInputEvent input = {OGInputEvent::MOUSE_MOVE, pos};
+    pSimulation_->PostInput(input);
+}
+
+// Only the buttons whose state changes are touched, so the scene cache
+// isn't invalidated by every mouse move
+void OpenGOO::_SetHoverButton(OGButton* button)
+{
+    if (button == _pHoverButton) return;
+
+    if (_pHoverButton)
     {
-        _pSelectedBall->MouseMove(pos);
+        _pHoverButton->up()->SetVisible(true);
+        _pHoverButton->over()->SetVisible(false);
     }
-    else if (!_pSelectedBall->TestPoint(pos))
+
+    if (button)
     {
-        _pSelectedBall->SetMarked(false);
-        _ClearSelectedBall();
+        button->up()->SetVisible(false);
+        button->over()->SetVisible(true);
     }
+
+    _pHoverButton = button;
 }
 
 void OpenGOO::_KeyDown(QKeyEvent* ev)
 {
-    Q_UNUSED(ev)
+    if (ev->key() == Qt::Key_F12) Metrics::Dump();
+}
+
+void OpenGOO::_UpdateRenderMetrics()
+{
+    static Metrics::Counter* frames = Metrics::GetCounter("render.frames");
+    static Metrics::Gauge* drawn = Metrics::GetGauge("render.drawn");
+    static Metrics::Gauge* culled = Metrics::GetGauge("render.culled");
+    static Metrics::Gauge* p50 = Metrics::GetGauge("render.frame_time_p50_ms");
+    static Metrics::Gauge* p99 = Metrics::GetGauge("render.frame_time_p99_ms");
+    static Metrics::Gauge* input50 = Metrics::GetGauge("input.latency_p50_ms");
+    static Metrics::Gauge* input99 = Metrics::GetGauge("input.latency_p99_ms");
+    static Metrics::Gauge* particles = Metrics::GetGauge("render.particles");
+
+    const OGFrameTimes &times = GE->getWindow()->frameScheduler().frameTimes();
+
+    frames->Add();
+    drawn->Set(renderStats_.drawn);
+    culled->Set(renderStats_.culled);
+    p50->Set(times.p50);
+    p99->Set(times.p99);
+    input50->Set(times.inputP50);
+    input99->Set(times.inputP99);
+    particles->Set(particles_.Count());
 }
 
 inline void OpenGOO::_ClearLayers()
 {
     layers_.clear();
+    sceneCaches_.clear();
+    particles_.Clear();
+    animations_.Clear();
+}
+
+// The layers under the first animated depth, then the layers between each
+// animated depth and the next one
+void OpenGOO::_CreateSceneCaches()
+{
+    const QVector<float> &depths = animations_.Depths();
+    float min = -std::numeric_limits<float>::infinity();
+
+    for (int i = 0; i <= depths.size(); i++)
+    {
+        sceneCaches_.emplace_back(new OGSceneCache);
+    }
+
+    for (int i = 0; i < depths.size(); i++)
+    {
+        sceneCaches_[i]->SetDepthRange(min, depths.at(i));
+        min = depths.at(i);
+    }
+
+    sceneCaches_.back()->SetDepthRange(min
+                                       , std::numeric_limits<float>::infinity());
 }
 
 inline void OpenGOO::_Quit() { OGGameEngine::getInstance()->quit(); }
@@ -437,6 +679,7 @@ void OpenGOO::_CreateContinueButton()
 
 void OpenGOO::_InitProgressWindow()
 {
+    isExitActive_ = false;
     pProgressWnd_.reset(new ProgressWindow);
     auto wnd = pProgressWnd_.get();
     connect(wnd, SIGNAL(close()), this, SLOT(_closeProgressWindow()));
@@ -446,6 +689,8 @@ void OpenGOO::_InitProgressWindow()
 // Level
 void OpenGOO::_LoadLevel(const QString &levelname)
 {
+    pSimulation_->Stop();
+
     if (!pWorld_->LoadLevel(levelname)) return;
     if (pWorld_->leveldata()->visualdebug) _SetDebug(true);
 
@@ -462,10 +707,17 @@ void OpenGOO::_LoadLevel(const QString &levelname)
         isContinue_ = false;
     }
     else { isLevelExit_ = false; }
+
+    searchTime_ = 0;
+    isExitActive_ = true;
+    pSimulation_->Start();
 }
 
 void OpenGOO::_CloseLevel()
 {
+    pSimulation_->Stop();
+    _ClearSelectedBall();
+    _pHoverButton = 0;
     pWorld_->CloseLevel();
     _ClearLayers();
     pCamera_ = 0;
@@ -473,9 +725,12 @@ void OpenGOO::_CloseLevel()
 
 void OpenGOO::ReloadLevel()
 {
+    pSimulation_->Stop();
+    _ClearSelectedBall();
     pWorld_->Reload();
     pCamera_->SetLastPosition();
     balls_ = 0;
+    pSimulation_->Start();
 }
 void OpenGOO::_CreateLevel(const QString &levelname)
 {
@@ -546,3 +801,13 @@ void OpenGOO::_closeProgressWindow()
     pProgressWnd_.reset();
     _backToIsland();
 }
+
+void OpenGOO::_openPipe()
+{
+    if (pWorld_->pipe()) pWorld_->pipe()->Open();
+}
+
+void OpenGOO::_closePipe()
+{
+    if (pWorld_->pipe()) pWorld_->pipe()->Close();
+}
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <atomic>
 #include <memory>
+#include <vector>
 
 #include <QColor>
 #include <QList>
@@ -8,11 +10,18 @@
 #include <QMap>
 #include <QPoint>
 #include <QString>
+#include <QVector>
 
 #include "GameEngine/og_game.h"
 #include "progresswindow.h"
 #include <OGIPushButton>
 #include "og_layer.h"
+#include "og_scenecache.h"
+#include "og_renderstats.h"
+#include "og_primitivebatch.h"
+#include "og_particlesystem.h"
+#include "og_animationsystem.h"
+#include "og_simulation.h"
 #include "island.h"
 #include "level.h"
 #include "og_fpscounter.h"
@@ -21,13 +30,15 @@
 
 class OGWindowCamera;
 class OGBall;
+class OGButton;
 
 
 class QTime;
 
-void visualDebug(QPainter* painter, OGWorld* world, qreal zoom);
+void visualDebug(OGPrimitiveBatch* batch, const OGRenderSnapshot &snapshot
+                 , qreal zoom);
 
-class OpenGOO : public og::OGGame
+class OpenGOO : public og::OGGame, public OGSimulation::Client
 {
     Q_OBJECT
 
@@ -44,9 +55,6 @@ class OpenGOO : public og::OGGame
         void SetLevelName(const QString &levelname);
         void SetLanguage(const QString &language);                
 
-        void OpenPipe();
-        void ClosePipe();
-
         void ShowProgress();
 
         void Quit() { _Quit(); }
@@ -55,12 +63,18 @@ class OpenGOO : public og::OGGame
 
         void AddSprite(float depth, OGSprite* sprite);
         void AddSprite(OGSprite* sprite);
+        // pos is in the scene coordinates, pretick in frames
+        void AddParticles(const WOGParticleEffect* effect, const QPointF &pos
+                          , float pretick);
+        // Returns false if the animation can't be loaded, then the sprite
+        // must be added to the layers
+        bool AddAnimation(OGSprite* sprite, const QString &name, float speed);
         void ClearSprites();
 
         void ReloadLevel();
 
         bool isPause() { return _pause; }
-        void SetPause(bool pause) { _pause = pause; }
+        void SetPause(bool pause);
 
         friend class Level;
         friend class MainMenu;
@@ -75,12 +89,17 @@ class OpenGOO : public og::OGGame
         static OpenGOO* pInstance_;
 
         OGWorld* pWorld_;
+        std::unique_ptr<OGSimulation> pSimulation_;
+        int searchTime_;
         std::unique_ptr<OGFPSCounter> _pFPS;
         OGWindowCamera* pCamera_;
 
         OGBall* _pSelectedBall;
         void _ClearSelectedBall() { _pSelectedBall = 0; }
 
+        OGButton* _pHoverButton;
+        void _SetHoverButton(OGButton* button);
+
         QString levelName_;
         QString language_;
         QString _currentIsland;
@@ -88,7 +107,6 @@ class OpenGOO : public og::OGGame
         int width_;
         int height_;
 
-        float timeStep_;
         float timeScrollStep_;        
 
         QTime* pGameTime_;
@@ -98,6 +116,7 @@ class OpenGOO : public og::OGGame
 
         bool isContinue_;
         bool isLevelExit_;
+        std::atomic<bool> isExitActive_; // false while the progress is shown
 
         QPoint lastMousePos_;
         QPoint curMousePos_;
@@ -113,6 +132,7 @@ class OpenGOO : public og::OGGame
 
         void _Cycle();
         void _Paint(QPainter* painter);
+        void _PaintOverlayLabels(QPainter* painter);
 
         void _MouseButtonDown(QMouseEvent* ev);
         void _MouseButtonUp(QMouseEvent* ev);
@@ -122,16 +142,29 @@ class OpenGOO : public og::OGGame
         void _KeyDown(QKeyEvent* ev);
         void _KeyUp(QKeyEvent* ev) { Q_UNUSED(ev)}
 
+        // Simulation thread
+        void SimInput(const OGInputEvent &ev);
+        void SimStep(int steps);
+        void SimSnapshot(OGRenderSnapshot* snapshot);
+
         // Layers
         QMap<float, OGLayer> layers_;
+        // Between the animated depths
+        std::vector<std::unique_ptr<OGSceneCache> > sceneCaches_;
+        OGRenderStats renderStats_;
+        OGPrimitiveBatch batch_;
+        OGParticleSystem particles_;
+        OGAnimationSystem animations_;
 
         void _ClearLayers();
+        void _CreateSceneCaches();
 
         void _Quit();
 
         void _SetDebug(bool debug);
 
         void _Scroll();
+        void _UpdateRenderMetrics();
         void _SetBackgroundColor(const QColor &color);        
 
         // Main menu
@@ -165,4 +198,6 @@ private slots:
         void _backToIsland();
         void _closeContinueButton();
         void _closeProgressWindow();
+        void _openPipe();
+        void _closePipe();
 };
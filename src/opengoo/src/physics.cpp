@@ -1,8 +1,6 @@
 #include "physics.h"
-#include "opengoo.h"
 #include "wog_scene.h"
 #include "wog_material.h"
-#include "og_world.h"
 
 #include <OGPhysicsEngine>
 #include <OGPhysicsBody>
@@ -64,9 +62,9 @@ OGPhysicsBody* createCircle(float x, float y, float radius
     return circle;
 }
 
-OGPhysicsBody* createLine(const QPointF &anchor, const QPointF &normal
-                          , WOGMaterial* material, bool dynamic
-                          , OGUserData* data)
+OGPhysicsBody* createLine(const WOGScene* scene, const QPointF &anchor
+                          , const QPointF &normal, WOGMaterial* material
+                          , bool dynamic, OGUserData* data)
 {
     float x1, x2, y1, y2, length, angle;
     OGPhysicsBody* line;
@@ -78,8 +76,8 @@ OGPhysicsBody* createLine(const QPointF &anchor, const QPointF &normal
 
     //0.55 = (length + 10%)/2
 
-    float wScene = sceneWidth();
-    float hScene = sceneHeight();
+    float wScene = sceneWidth(scene);
+    float hScene = sceneHeight(scene);
     length = qMax(wScene, hScene) * 0.55f * K;
 
     x2 = x1 + normal.x();
@@ -184,19 +182,19 @@ OGPhysicsJoint* createJoint(OGPhysicsBody* b1, OGPhysicsBody* b2
 {
     OGPhysicsJoint* joint;
     OGPhysicsEngine* engine;
-    b2DistanceJointDef* jointDef;
+    b2DistanceJointDef jointDef;
 
     engine = OGPhysicsEngine::GetInstance();
     joint = new OGPhysicsJoint();
-    jointDef = new b2DistanceJointDef;
-    jointDef->frequencyHz = 1.5f;
-    jointDef->dampingRatio = 0.9f;
+    jointDef.frequencyHz = 1.5f;
+    jointDef.dampingRatio = 0.9f;
 
-    jointDef->Initialize(b1->body, b2->body
-                         , b1->body->GetPosition(), b2->body->GetPosition());
+    jointDef.Initialize(b1->body, b2->body
+                        , b1->body->GetPosition(), b2->body->GetPosition());
 
-    joint->jointdef = jointDef;
+    joint->jointdef = &jointDef;
     engine->CreateJoint(joint);
+    joint->jointdef = 0;
     joint->joint->SetUserData(data);
 
     return joint;
@@ -217,21 +215,12 @@ void setBodyPosition(OGPhysicsBody* b, float x, float y)
     b->body->SetAwake(false);
 }
 
-WOGScene* physics::GetScene()
-{       
-    return OpenGOO::instance()->GetWorld()->scenedata();
-}
-
-float physics::sceneWidth()
+float physics::sceneWidth(const WOGScene* scene)
 {
-    WOGScene* scene = GetScene();
-
     return scene->maxx - scene->minx;
 }
 
-float physics::sceneHeight()
+float physics::sceneHeight(const WOGScene* scene)
 {
-    WOGScene* scene = GetScene();
-
     return scene->maxy - scene->miny;
 }
@@ -27,9 +27,8 @@ const uint16 EXIT = 0x0020;
 const uint16 SENSOR = 0x0040;
 const uint16 STATIC = LINE | CIRCLE | RECTANGLE;
 
-WOGScene* GetScene();
-float sceneWidth();
-float sceneHeight();
+float sceneWidth(const WOGScene* scene);
+float sceneHeight(const WOGScene* scene);
 }
 
 bool initializePhysicsEngine(const QPointF &gravity, bool sleep);
@@ -43,9 +42,10 @@ og::OGPhysicsBody* createCircle(const QPointF &position, float radius
                             , bool dynamic = false, float mass = 0
                                     , OGUserData* data = 0);
 
-og::OGPhysicsBody* createLine(const QPointF &anchor, const QPointF &normal
-                          , WOGMaterial* material, bool dynamic = false
-                                  , OGUserData* data = 0);
+// The line is as long as the scene, which gives its size
+og::OGPhysicsBody* createLine(const WOGScene* scene, const QPointF &anchor
+                          , const QPointF &normal, WOGMaterial* material
+                          , bool dynamic = false, OGUserData* data = 0);
 
 og::OGPhysicsBody* createRectangle(float x, float y, float width
                                , float height, float angle
@@ -1,21 +1,13 @@
 #include <QString>
 
-#include "opengoo.h"
 #include "wog_pipe.h"
 #include "wog_resources.h"
 
 #include "spritefactory.h"
 
-
-WOGResources* SpriteFactory::GetResourceManager()
-{
-    return OpenGOO::instance()->GetWorld()->resrcdata();
-}
-
-ImageSourcePtr SpriteFactory::CreateImageSource(const QString& a_id)
+ImageSourcePtr SpriteFactory::CreateImageSource(const QString& a_id) const
 {
-    WOGResources* rm = GetResourceManager();
-    QString filename = rm->GetImage(a_id) + ".png";
+    QString filename = m_resources->GetImage(a_id) + ".png";
 
     return std::make_shared<og::ImageSource>(filename);
 }
@@ -8,11 +8,19 @@ struct WOGPipe;
 class QString;
 class QPointF;
 
+// The images are looked up in the resources of the world the sprites
+// are made for
 class SpriteFactory
 {
-public:    
-    static WOGResources* GetResourceManager();
-    static ImageSourcePtr CreateImageSource(const QString& a_id);
+    const WOGResources* m_resources;
+
+public:
+    explicit SpriteFactory(const WOGResources* a_resources)
+        : m_resources(a_resources)
+    {
+    }
+
+    ImageSourcePtr CreateImageSource(const QString& a_id) const;
 
     OGSprite* CreateCap(WOGPipe* a_pipe, const QString& a_id, bool a_visible);
     OGSprite* CreateBend(const QString& a_type,
@@ -0,0 +1,62 @@
+#include "uiregistry.h"
+
+#include <logger.h>
+
+#include <QDomDocument>
+#include <QFile>
+
+const QString UIRegistry::DEFAULT_FILE(":/ui/resources.xml");
+
+QHash<QString, UIData> UIRegistry::descriptors_;
+bool UIRegistry::isLoaded_ = false;
+
+bool UIRegistry::Load(const QString &filename)
+{
+    isLoaded_ = true;
+    descriptors_.clear();
+
+    QFile file(filename);
+    QDomDocument domDoc;
+
+    if (!file.open(QIODevice::ReadOnly) || !domDoc.setContent(&file))
+    {
+        logWarn("File " + filename + " is corrupted");
+        return false;
+    }
+
+    QDomElement element = domDoc.documentElement().firstChildElement();
+
+    for (; !element.isNull(); element = element.nextSiblingElement())
+    {
+        QString id = element.attribute("id");
+
+        // The first one wins, as it did when the file was searched
+        if (descriptors_.contains(id)) continue;
+
+        UIData data;
+        data.width = element.attribute("width").toInt();
+        data.height = element.attribute("height").toInt();
+        data.up = element.attribute("up");
+        data.over = element.attribute("over");
+        data.text = element.attribute("text");
+
+        descriptors_.insert(id, data);
+    }
+
+    return true;
+}
+
+const UIData* UIRegistry::Get(const QString &id)
+{
+    if (!isLoaded_) Load();
+
+    QHash<QString, UIData>::const_iterator it = descriptors_.constFind(id);
+
+    if (it == descriptors_.constEnd())
+    {
+        logWarn("Wrong ui id: " + id);
+        return 0;
+    }
+
+    return &it.value();
+}
@@ -0,0 +1,28 @@
+#ifndef UIREGISTRY_H
+#define UIREGISTRY_H
+
+#include <QHash>
+#include <QString>
+
+#include "uidata.h"
+
+// The descriptors of the buttons of the menus, parsed once from
+// :/ui/resources.xml. The menus are created again each time they are
+// opened, a lookup costs them no parsing.
+class UIRegistry
+{
+    public:
+        // Called at startup; Get() loads the default file if it wasn't
+        static bool Load(const QString &filename = DEFAULT_FILE);
+
+        // Returns 0 for an unknown id
+        static const UIData* Get(const QString &id);
+
+    private:
+        static const QString DEFAULT_FILE;
+
+        static QHash<QString, UIData> descriptors_;
+        static bool isLoaded_;
+};
+
+#endif // UIREGISTRY_H
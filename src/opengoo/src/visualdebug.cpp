@@ -2,6 +2,8 @@
 #include "wog_level.h"
 #include "og_ball.h"
 #include "flags.h"
+#include "og_primitivebatch.h"
+#include "og_rendersnapshot.h"
 
 #include <QPainter>
 #include <QTime>
@@ -20,25 +22,16 @@ const qreal DEGREE = 57.2957795;
 
 using namespace visual_debug;
 
-void visualDebug(QPainter* painter, OGWorld* world, qreal zoom)
+void visualDebug(OGPrimitiveBatch* batch, const OGRenderSnapshot &snapshot
+                 , qreal zoom)
 {
     QPen pen(Qt::yellow,  2.0 * zoom);
 
-    painter->setOpacity(1);
-    painter->setPen(pen);
+    batch->AddCircle(QPointF(0, 0), 10.0 * zoom, pen); // center of word
 
-    painter->drawEllipse(QPointF(0, 0), 10.0 * zoom, 10.0 * zoom); // center of word   
-
-    if (world->nearestball() != 0)
+    if (snapshot.hasNearestBall)
     {
-        qreal x, y;
-
-        QPointF pos = world->nearestball()->GetPosition().toPointF();
-        x = pos.x() * K;
-        y = pos.y() * K * (-1);
-
         pen.setColor(Qt::green);
-        painter->setPen(pen);
-        painter->drawEllipse(QPointF(x, y), 10, 10);
+        batch->AddCircle(snapshot.nearestBall, 10, pen);
     }
 }